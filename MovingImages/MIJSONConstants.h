@@ -282,6 +282,12 @@ extern NSString *const MIJSONKeyArrayOfPathElements;
 /// The key for representing an SVG style path representation. "svgpath"
 extern NSString *const MIJSONKeySVGPath;
 
+/// The key for an array of svgpath strings shared by elements. "svgpaths"
+extern NSString *const MIJSONKeySVGPaths;
+
+/// The key for the index of an element's path in svgpaths. "svgpathindex"
+extern NSString *const MIJSONKeySVGPathIndex;
+
 /// The key for representing a rectangle. "rect". Made of: { origin, size }.
 extern NSString *const MIJSONKeyRect;
 
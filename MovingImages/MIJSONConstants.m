@@ -57,6 +57,8 @@ NSString *const MIJSONKeyVariablesDictionary = @"variables";
 
 NSString *const MIJSONKeyArrayOfPathElements = @"arrayofpathelements";
 NSString *const MIJSONKeySVGPath = @"svgpath";
+NSString *const MIJSONKeySVGPaths = @"svgpaths";
+NSString *const MIJSONKeySVGPathIndex = @"svgpathindex";
 
 // Color related keys.
 
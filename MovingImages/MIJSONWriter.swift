@@ -0,0 +1,185 @@
+//
+//  MIJSONWriter.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+/// Options for writing MovingImages JSON more compactly than
+/// NSJSONSerialization does.
+public struct MIJSONWriterOptions {
+    /// How numbers and the coordinates in path data are rounded.
+    public var precision = SVGNumberFormatter.Precision.shortest
+
+    /// Path data is rewritten with relative commands.
+    public var relativePathData = false
+
+    public var prettyPrinted = false
+
+    /// Numbers anywhere inside the values of these keys are written at full
+    /// precision. By default color components, alphas and gradient
+    /// locations, which are all in the range 0 to 1.
+    public var fullPrecisionKeys: Set<String> = [
+        MIJSONKeyRed, MIJSONKeyGreen, MIJSONKeyBlue, MIJSONKeyAlpha,
+        MIJSONKeyContextAlpha, MIJSONKeyArrayOfLocations
+    ]
+
+    public init() {
+    }
+}
+
+/// Writes a JSON object made of dictionaries, arrays, strings and numbers.
+public final class MIJSONWriter {
+    public let options: MIJSONWriterOptions
+    private let formatter: SVGNumberFormatter
+    private let fullPrecisionFormatter = SVGNumberFormatter()
+    private var output = ""
+
+    public init(options: MIJSONWriterOptions) {
+        self.options = options
+        self.formatter = SVGNumberFormatter(precision: options.precision)
+    }
+
+    public func stringFromJSONObject(jsonObject: AnyObject) -> String? {
+        output = ""
+        defer {
+            output = ""
+        }
+        guard writeValue(jsonObject, key: .None, indent: 0, fullPrecision: false) else {
+            return .None
+        }
+        return output
+    }
+
+    private func writeValue(value: AnyObject, key: String?, indent: Int, fullPrecision: Bool) -> Bool {
+        switch value {
+            case let dictionary as NSDictionary:
+                // Keys are sorted so the output doesn't depend on hashing.
+                var keys = [String]()
+                for key in dictionary.allKeys {
+                    guard let key = key as? String else {
+                        return false
+                    }
+                    keys.append(key)
+                }
+                keys.sortInPlace()
+                output += "{"
+                for (index, key) in keys.enumerate() {
+                    output += index == 0 ? "" : ","
+                    writeNewline(indent + 1)
+                    writeString(key)
+                    output += options.prettyPrinted ? " : " : ":"
+                    let fullPrecision = fullPrecision || options.fullPrecisionKeys.contains(key)
+                    if !writeValue(dictionary[key]!, key: key, indent: indent + 1, fullPrecision: fullPrecision) {
+                        return false
+                    }
+                }
+                if !keys.isEmpty {
+                    writeNewline(indent)
+                }
+                output += "}"
+            case let array as NSArray:
+                output += "["
+                for (index, element) in array.enumerate() {
+                    output += index == 0 ? "" : ","
+                    writeNewline(indent + 1)
+                    if !writeValue(element, key: key, indent: indent + 1, fullPrecision: fullPrecision) {
+                        return false
+                    }
+                }
+                if array.count > 0 {
+                    writeNewline(indent)
+                }
+                output += "]"
+            case let string as String:
+                if key == MIJSONKeySVGPath || key == MIJSONKeySVGPaths {
+                    writeString(svgPathData(string))
+                }
+                else {
+                    writeString(string)
+                }
+            case let number as NSNumber:
+                writeNumber(number, fullPrecision: fullPrecision)
+            case is NSNull:
+                output += "null"
+            default:
+                return false
+        }
+        return true
+    }
+
+    private func writeNewline(indent: Int) {
+        if options.prettyPrinted {
+            output += "\n" + String(count: indent * 2, repeatedValue: Character(" "))
+        }
+    }
+
+    private func writeNumber(number: NSNumber, fullPrecision: Bool) {
+        if CFGetTypeID(number) == CFBooleanGetTypeID() {
+            output += number.boolValue ? "true" : "false"
+            return
+        }
+        switch String.fromCString(number.objCType) ?? "" {
+            case "f", "d":
+                let numberFormatter = fullPrecision ? fullPrecisionFormatter : formatter
+                output += numberFormatter.format(number.doubleValue)
+            case "Q":
+                output += String(number.unsignedLongLongValue)
+            default:
+                output += String(number.longLongValue)
+        }
+    }
+
+    private func writeString(string: String) {
+        output += "\""
+        for scalar in string.unicodeScalars {
+            switch scalar {
+                case "\"":
+                    output += "\\\""
+                case "\\":
+                    output += "\\\\"
+                case "\n":
+                    output += "\\n"
+                case "\r":
+                    output += "\\r"
+                case "\t":
+                    output += "\\t"
+                default:
+                    if scalar.value < 0x20 {
+                        output += String(format: "\\u%04x", scalar.value)
+                    }
+                    else {
+                        output.append(scalar)
+                    }
+            }
+        }
+        output += "\""
+    }
+
+    // Path data is only rewritten when the options change how it's written.
+    // Arcs come back as cubic curves.
+    private func svgPathData(svgPath: String) -> String {
+        if case .shortest = options.precision where !options.relativePathData {
+            return svgPath
+        }
+        let geometry = SVGPathGeometry(path: MICGPathCreateFromSVGPath(svgPath))
+        return geometry.svgPath(formatter, relative: options.relativePathData)
+    }
+}
+
+// MARK: -
+
+/// Converts jsonObject to text with options, rather than with
+/// NSJSONSerialization.
+public func jsonObjectToString(jsonObject: AnyObject, options: MIJSONWriterOptions) -> String? {
+    let string = SVGInstrumentation.time(.serialize) {
+        MIJSONWriter(options: options).stringFromJSONObject(jsonObject)
+    }
+    if SVGInstrumentation.enabled {
+        SVGInstrumentation.count("bytes.out", by: string?.utf8.count ?? 0)
+    }
+    return string
+}
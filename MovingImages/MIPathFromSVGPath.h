@@ -6,6 +6,18 @@
 
 @import Foundation;
 
+/// The default largest distance, in path units, between an arc and the
+/// cubic curves that approximate it.
+extern const CGFloat MI_SVGDefaultArcTolerance;
+
+/// An arc is never split into more cubic curves than this.
+#define MI_SVGMaximumArcSegments 1024
+
 extern void MI_CGPathFromSVGPath(CGMutablePathRef inPath, NSMutableArray *pathArray,
                                  const char* s);
 
+/// Arcs are approximated to within tolerance. Pass the device tolerance
+/// divided by the scale the path will be drawn at. pathArray can be nil.
+extern void MI_CGPathFromSVGPathWithTolerance(CGMutablePathRef inPath, NSMutableArray *pathArray,
+                                              const char* s, CGFloat tolerance);
+
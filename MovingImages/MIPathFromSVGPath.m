@@ -12,6 +12,8 @@
 #import "MIPathFromSVGPath.h"
 #import "MIJSONConstants.h"
 
+#import <Accelerate/Accelerate.h>
+
 #include <tgmath.h>
 #include <string.h>
 #include <stdlib.h>
@@ -138,17 +140,48 @@ static void mi_svg_xformVec(CGFloat* dx, CGFloat* dy, CGFloat x, CGFloat y, cons
     *dy = x*t[1] + y*t[3];
 }
 
+NSDictionary *MI_CreateLinetoDictionary(CGFloat x, CGFloat y);
 NSDictionary *MI_CreateCurveDictionary(CGFloat cp1x, CGFloat cp1y, CGFloat cp2x,
                                        CGFloat cp2y, CGFloat x, CGFloat y);
 
-static void mi_svg_pathArcTo(NSMutableArray *pathArray, CGMutablePathRef path, const CGFloat* args, bool rel)
+const CGFloat MI_SVGDefaultArcTolerance = 0.01;
+
+// The largest distance between an arc of radius r spanning angle and the
+// cubic bezier that approximates it.
+static CGFloat mi_svg_arcError(CGFloat r, CGFloat angle)
+{
+    CGFloat s = sin(angle / 4.0);
+    CGFloat c = cos(angle / 4.0);
+    return r * (2.0 / 27.0) * pow(s, 6.0) / (c * c);
+}
+
+// The number of cubics needed to approximate an arc of radius r spanning
+// angle to within tolerance. No cubic spans more than half a turn. With no
+// tolerance arcs are split into quarter turns.
+static int mi_svg_arcSegmentCount(CGFloat r, CGFloat angle, CGFloat tolerance)
+{
+    angle = fabs(angle);
+    if (tolerance <= 0.0) {
+        return MAX(1, (int)(angle / M_PI_2 + 0.5));
+    }
+    // Small angle estimate from error ≈ r * (2/27) * (θ/4)^6, then corrected.
+    CGFloat maxAngle = MIN(M_PI, 4.0 * pow(27.0 * tolerance / (2.0 * r), 1.0 / 6.0));
+    int n = MAX(1, (int)ceil(angle / maxAngle));
+    while (n < MI_SVGMaximumArcSegments && mi_svg_arcError(r, angle / n) > tolerance) {
+        n++;
+    }
+    return MIN(n, MI_SVGMaximumArcSegments);
+}
+
+static void mi_svg_pathArcTo(NSMutableArray *pathArray, CGMutablePathRef path, const CGFloat* args,
+                             bool rel, CGFloat tolerance)
 {
     // Ported from canvg (https://code.google.com/p/canvg/)
     CGFloat rx, ry, rotx;
     CGFloat x1, y1, x2, y2, cx, cy, dx, dy, d;
     CGFloat x1p, y1p, cxp, cyp, s, sa, sb;
     CGFloat ux, uy, vx, vy, a1, da;
-    CGFloat x, y, tanx, tany, a, px=0, py=0, ptanx=0, ptany=0, t[6];
+    CGFloat x, y, tanx, tany, px=0, py=0, ptanx=0, ptany=0, t[6];
     CGFloat sinrx, cosrx;
     int fa, fs;
     int i, ndivs;
@@ -176,6 +209,7 @@ static void mi_svg_pathArcTo(NSMutableArray *pathArray, CGMutablePathRef path, c
     if (d < 1e-6f || rx < 1e-6f || ry < 1e-6f) {
         // The arc degenerates to a line
         CGPathAddLineToPoint(path, nil, x2, y2);
+        if (pathArray) [pathArray addObject:MI_CreateLinetoDictionary(x2, y2)];
         return;
     }
     
@@ -233,34 +267,39 @@ static void mi_svg_pathArcTo(NSMutableArray *pathArray, CGMutablePathRef path, c
     t[2] = -sinrx; t[3] = cosrx;
     t[4] = cx; t[5] = cy;
     
-    // Split arc into max 90 degree segments.
-    ndivs = (int)(fabs(da) / M_PI_2 + 0.5f);
+    // Split the arc into as few segments as keep it within tolerance.
+    ndivs = mi_svg_arcSegmentCount(MAX(rx, ry), da, tolerance);
     hda = (da / (CGFloat)ndivs) / 2.0f;
     kappa = fabs(4.0f / 3.0f * (1.0f - cos(hda)) / sin(hda));
     if (da < 0.0f)
         kappa = -kappa;
 
-    NSDictionary *elementDict;
+    // The sines and cosines of the segment end angles are calculated together.
+    CGFloat angles[MI_SVGMaximumArcSegments + 1];
+    CGFloat sines[MI_SVGMaximumArcSegments + 1];
+    CGFloat cosines[MI_SVGMaximumArcSegments + 1];
+    int count = ndivs + 1;
     for (i = 0; i <= ndivs; i++) {
-        a = a1 + da * (i/(CGFloat)ndivs);
-        dx = cos(a);
-        dy = sin(a);
+        angles[i] = a1 + da * (i/(CGFloat)ndivs);
+    }
+#if CGFLOAT_IS_DOUBLE
+    vvsincos(sines, cosines, angles, &count);
+#else
+    vvsincosf(sines, cosines, angles, &count);
+#endif
+
+    // The end point was included in the center, so the points are absolute
+    // for relative arcs too.
+    for (i = 0; i <= ndivs; i++) {
+        dx = cosines[i];
+        dy = sines[i];
         mi_svg_xformPoint(&x, &y, dx*rx, dy*ry, t); // position
         mi_svg_xformVec(&tanx, &tany, -dy*rx * kappa, dx*ry * kappa, t); // tangent
         if (i > 0) {
-            if (rel) {
-                CGPathAddCurveToPoint(path, nil, px+ptanx+end.x, py+ptany+end.y,
-                                      x-tanx+end.x, y-tany+end.y, x+end.x, y+end.y);
-                elementDict = MI_CreateCurveDictionary(px+ptanx+end.x, py+ptany+end.y,
-                                                       x-tanx+end.x, y-tany+end.y,
-                                                       x+end.x, y+end.y);
-                [pathArray addObject:elementDict];
-
-            } else {
-                CGPathAddCurveToPoint(path, nil, px+ptanx, py+ptany, x-tanx, y-tany, x, y);
-                elementDict = MI_CreateCurveDictionary(px+ptanx, py+ptany,
-                                                       x-tanx, y-tany, x, y);
-                [pathArray addObject:elementDict];
+            CGPathAddCurveToPoint(path, nil, px+ptanx, py+ptany, x-tanx, y-tany, x, y);
+            if (pathArray) {
+                [pathArray addObject:MI_CreateCurveDictionary(px+ptanx, py+ptany,
+                                                              x-tanx, y-tany, x, y)];
             }
         }
         px = x;
@@ -349,6 +388,13 @@ NSDictionary *MI_CreateQuadCurveDictionary(CGFloat cp1x, CGFloat cp1y,
 
 void MI_CGPathFromSVGPath(CGMutablePathRef path, NSMutableArray *pathArray,
                           const char* s)
+{
+    MI_CGPathFromSVGPathWithTolerance(path, pathArray, s, MI_SVGDefaultArcTolerance);
+}
+
+// pathArray can be nil when only the CGPath is wanted.
+void MI_CGPathFromSVGPathWithTolerance(CGMutablePathRef path, NSMutableArray *pathArray,
+                                       const char* s, CGFloat tolerance)
 {
     char item[64];
     char cmd = 0;
@@ -368,7 +414,7 @@ void MI_CGPathFromSVGPath(CGMutablePathRef path, NSMutableArray *pathArray,
             nargs = 0;
             if (cmd == 'Z' || cmd == 'z') {
                 CGPathCloseSubpath(path);
-                [pathArray addObject:MI_CreateCloseSubpathDictionary()];
+                if (pathArray) [pathArray addObject:MI_CreateCloseSubpathDictionary()];
             }
         } else {
             if (nargs < 10)
@@ -380,13 +426,17 @@ void MI_CGPathFromSVGPath(CGMutablePathRef path, NSMutableArray *pathArray,
                         if (cmd == 'm' && hasCurrent == YES) {
                             end = CGPathGetCurrentPoint(path);
                             CGPathMoveToPoint(path, nil, args[0]+end.x, args[1]+end.y);
-                            elementDict = MI_CreateMovetoDictionary(args[0] + end.x,
-                                                                    args[1]+end.y);
-                            [pathArray addObject:elementDict];
+                            if (pathArray) {
+                                elementDict = MI_CreateMovetoDictionary(args[0] + end.x,
+                                                                        args[1]+end.y);
+                                [pathArray addObject:elementDict];
+                            }
                         } else {
                             CGPathMoveToPoint(path, nil, args[0], args[1]);
-                            elementDict = MI_CreateMovetoDictionary(args[0], args[1]);
-                            [pathArray addObject:elementDict];
+                            if (pathArray) {
+                                elementDict = MI_CreateMovetoDictionary(args[0], args[1]);
+                                [pathArray addObject:elementDict];
+                            }
                             hasCurrent = YES;
                         }
                         // Moveto can be followed by multiple coordinate pairs,
@@ -399,13 +449,17 @@ void MI_CGPathFromSVGPath(CGMutablePathRef path, NSMutableArray *pathArray,
                         if (cmd == 'l') {
                             end = CGPathGetCurrentPoint(path);
                             CGPathAddLineToPoint(path, nil, args[0]+end.x, args[1]+end.y);
-                            elementDict = MI_CreateLinetoDictionary(args[0]+end.x,
-                                                                    args[1]+end.y);
-                            [pathArray addObject:elementDict];
+                            if (pathArray) {
+                                elementDict = MI_CreateLinetoDictionary(args[0]+end.x,
+                                                                        args[1]+end.y);
+                                [pathArray addObject:elementDict];
+                            }
                         } else {
                             CGPathAddLineToPoint(path, nil, args[0], args[1]);
-                            elementDict = MI_CreateLinetoDictionary(args[0], args[1]);
-                            [pathArray addObject:elementDict];
+                            if (pathArray) {
+                                elementDict = MI_CreateLinetoDictionary(args[0], args[1]);
+                                [pathArray addObject:elementDict];
+                            }
                         }
                         break;
                     case 'H':
@@ -413,16 +467,20 @@ void MI_CGPathFromSVGPath(CGMutablePathRef path, NSMutableArray *pathArray,
                         end = CGPathGetCurrentPoint(path);
                         CGFloat x = cmd == 'h' ? args[0] + end.x : args[0];
                         CGPathAddLineToPoint(path, nil, x, end.y);
-                        elementDict = MI_CreateLinetoDictionary(x, end.y);
-                        [pathArray addObject:elementDict];
+                        if (pathArray) {
+                            elementDict = MI_CreateLinetoDictionary(x, end.y);
+                            [pathArray addObject:elementDict];
+                        }
                         break;
                     case 'V':
                     case 'v':
                         end = CGPathGetCurrentPoint(path);
                         CGPathAddLineToPoint(path, nil, end.x, cmd == 'v' ? args[0] + end.y : args[0]);
                         CGFloat y = cmd == 'v' ? args[0] + end.y : args[0];
-                        elementDict = MI_CreateLinetoDictionary(end.x, y);
-                        [pathArray addObject:elementDict];
+                        if (pathArray) {
+                            elementDict = MI_CreateLinetoDictionary(end.x, y);
+                            [pathArray addObject:elementDict];
+                        }
                         break;
                     case 'C':
                     case 'c':
@@ -430,22 +488,26 @@ void MI_CGPathFromSVGPath(CGMutablePathRef path, NSMutableArray *pathArray,
                             end = CGPathGetCurrentPoint(path);
                             CGPathAddCurveToPoint(path, nil, args[0]+end.x, args[1]+end.y,
                                                   args[2]+end.x, args[3]+end.y, args[4]+end.x, args[5]+end.y);
-                            elementDict = MI_CreateCurveDictionary(args[0]+end.x,
-                                                                   args[1]+end.y,
-                                                                   args[2]+end.x,
-                                                                   args[3]+end.y,
-                                                                   args[4]+end.x,
-                                                                   args[5]+end.y);
-                            [pathArray addObject:elementDict];
+                            if (pathArray) {
+                                elementDict = MI_CreateCurveDictionary(args[0]+end.x,
+                                                                       args[1]+end.y,
+                                                                       args[2]+end.x,
+                                                                       args[3]+end.y,
+                                                                       args[4]+end.x,
+                                                                       args[5]+end.y);
+                                [pathArray addObject:elementDict];
+                            }
                         } else {
                             CGPathAddCurveToPoint(path, nil, args[0], args[1], args[2], args[3], args[4], args[5]);
-                            elementDict = MI_CreateCurveDictionary(args[0],
-                                                                   args[1],
-                                                                   args[2],
-                                                                   args[3],
-                                                                   args[4],
-                                                                   args[5]);
-                            [pathArray addObject:elementDict];
+                            if (pathArray) {
+                                elementDict = MI_CreateCurveDictionary(args[0],
+                                                                       args[1],
+                                                                       args[2],
+                                                                       args[3],
+                                                                       args[4],
+                                                                       args[5]);
+                                [pathArray addObject:elementDict];
+                            }
                         }
                         break;
                     case 'S':
@@ -455,23 +517,27 @@ void MI_CGPathFromSVGPath(CGMutablePathRef path, NSMutableArray *pathArray,
                             end = CGPathGetCurrentPoint(path);
                             CGPathAddCurveToPoint(path, nil, cp1.x, cp1.y, args[0]+end.x, args[1]+end.y,
                                                   args[2]+end.x, args[3]+end.y);
-                            elementDict = MI_CreateCurveDictionary(cp1.x,
-                                                                   cp1.y,
-                                                                   args[0]+end.x,
-                                                                   args[1]+end.y,
-                                                                   args[2]+end.x,
-                                                                   args[3]+end.y);
-                            [pathArray addObject:elementDict];
+                            if (pathArray) {
+                                elementDict = MI_CreateCurveDictionary(cp1.x,
+                                                                       cp1.y,
+                                                                       args[0]+end.x,
+                                                                       args[1]+end.y,
+                                                                       args[2]+end.x,
+                                                                       args[3]+end.y);
+                                [pathArray addObject:elementDict];
+                            }
 
                         } else {
                             CGPathAddCurveToPoint(path, nil, cp1.x, cp1.y, args[0], args[1], args[2], args[3]);
-                            elementDict = MI_CreateCurveDictionary(cp1.x,
-                                                                   cp1.y,
-                                                                   args[0],
-                                                                   args[1],
-                                                                   args[2],
-                                                                   args[3]);
-                            [pathArray addObject:elementDict];
+                            if (pathArray) {
+                                elementDict = MI_CreateCurveDictionary(cp1.x,
+                                                                       cp1.y,
+                                                                       args[0],
+                                                                       args[1],
+                                                                       args[2],
+                                                                       args[3]);
+                                [pathArray addObject:elementDict];
+                            }
                         }
                         break;
                     }
@@ -481,18 +547,22 @@ void MI_CGPathFromSVGPath(CGMutablePathRef path, NSMutableArray *pathArray,
                             end = CGPathGetCurrentPoint(path);
                             CGPathAddQuadCurveToPoint(path, nil, args[0]+end.x, args[1]+end.y,
                                                       args[2]+end.x, args[3]+end.y);
-                            elementDict = MI_CreateQuadCurveDictionary(args[0]+end.x,
-                                                                       args[1]+end.y,
-                                                                       args[2]+end.x,
-                                                                       args[3]+end.y);
-                            [pathArray addObject:elementDict];
+                            if (pathArray) {
+                                elementDict = MI_CreateQuadCurveDictionary(args[0]+end.x,
+                                                                           args[1]+end.y,
+                                                                           args[2]+end.x,
+                                                                           args[3]+end.y);
+                                [pathArray addObject:elementDict];
+                            }
                         } else {
                             CGPathAddQuadCurveToPoint(path, nil, args[0], args[1], args[2], args[3]);
-                            elementDict = MI_CreateQuadCurveDictionary(args[0],
-                                                                       args[1],
-                                                                       args[2],
-                                                                       args[3]);
-                            [pathArray addObject:elementDict];
+                            if (pathArray) {
+                                elementDict = MI_CreateQuadCurveDictionary(args[0],
+                                                                           args[1],
+                                                                           args[2],
+                                                                           args[3]);
+                                [pathArray addObject:elementDict];
+                            }
                         }
                         break;
                     case 'T':
@@ -501,24 +571,28 @@ void MI_CGPathFromSVGPath(CGMutablePathRef path, NSMutableArray *pathArray,
                         if (cmd == 't') {
                             end = CGPathGetCurrentPoint(path);
                             CGPathAddQuadCurveToPoint(path, nil, cp1.x, cp1.y, args[0]+end.x, args[1]+end.y);
-                            elementDict = MI_CreateQuadCurveDictionary(cp1.x,
-                                                                       cp1.y,
-                                                                       args[0]+end.x,
-                                                                       args[1]+end.x);
-                            [pathArray addObject:elementDict];
+                            if (pathArray) {
+                                elementDict = MI_CreateQuadCurveDictionary(cp1.x,
+                                                                           cp1.y,
+                                                                           args[0]+end.x,
+                                                                           args[1]+end.y);
+                                [pathArray addObject:elementDict];
+                            }
                         } else {
                             CGPathAddQuadCurveToPoint(path, nil, cp1.x, cp1.y, args[0], args[1]);
-                            elementDict = MI_CreateQuadCurveDictionary(cp1.x,
-                                                                       cp1.y,
-                                                                       args[0],
-                                                                       args[1]);
-                            [pathArray addObject:elementDict];
+                            if (pathArray) {
+                                elementDict = MI_CreateQuadCurveDictionary(cp1.x,
+                                                                           cp1.y,
+                                                                           args[0],
+                                                                           args[1]);
+                                [pathArray addObject:elementDict];
+                            }
                         }
                         break;
                     }
                     case 'A':
                     case 'a':
-                        mi_svg_pathArcTo(pathArray, path, args, cmd == 'a' ? 1 : 0);
+                        mi_svg_pathArcTo(pathArray, path, args, cmd == 'a' ? 1 : 0, tolerance);
                         break;
                     default:
                         break;
@@ -5,9 +5,27 @@
 
 import Foundation
 
-public func MICGPathCreateFromSVGPath(d:String, inout pathArray: NSMutableArray) -> CGMutablePath
+public func MICGPathCreateFromSVGPath(d:String, inout pathArray: NSMutableArray,
+                                      tolerance: CGFloat = MI_SVGDefaultArcTolerance) -> CGMutablePath
 {
     let path = CGPathCreateMutable()
-    MI_CGPathFromSVGPath(path, pathArray, d)
+    withSVGPathBytes(d) { MI_CGPathFromSVGPathWithTolerance(path, pathArray, $0, tolerance) }
     return path
 }
+
+/// Creates just the CGPath, without building the MovingImages path elements.
+public func MICGPathCreateFromSVGPath(d:String, tolerance: CGFloat = MI_SVGDefaultArcTolerance) -> CGMutablePath
+{
+    let path = CGPathCreateMutable()
+    withSVGPathBytes(d) { MI_CGPathFromSVGPathWithTolerance(path, nil, $0, tolerance) }
+    return path
+}
+
+/// Passing the string itself copies it to a new C string. Path data that came
+/// from the XML parser is usually already UTF-8 and is read in place.
+private func withSVGPathBytes(d: String, @noescape body: UnsafePointer<Int8> -> Void) {
+    let nsString = d as NSString
+    withExtendedLifetime(nsString) {
+        body(nsString.UTF8String)
+    }
+}
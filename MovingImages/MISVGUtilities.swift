@@ -12,9 +12,12 @@ let defaultSaveFolder = "~/Desktop/Current/swiftsvg"
 
 func jsonObjectToString(jsonObject: AnyObject) -> String? {
     if NSJSONSerialization.isValidJSONObject(jsonObject) {
-        let data = try? NSJSONSerialization.dataWithJSONObject(jsonObject,
+        let data = SVGInstrumentation.time(.serialize) {
+            try? NSJSONSerialization.dataWithJSONObject(jsonObject,
                        options: NSJSONWritingOptions.PrettyPrinted)
                     // options: NSJSONWritingOptions.init(rawValue: 0))
+        }
+        SVGInstrumentation.count("bytes.out", by: data?.length ?? 0)
         if let data = data,
             let jsonString = NSString(data: data, encoding: NSUTF8StringEncoding) {
                 return jsonString as String
@@ -23,8 +26,16 @@ func jsonObjectToString(jsonObject: AnyObject) -> String? {
     return nil
 }
 
-public func writeMovingImagesJSONObject(jsonObject: [NSString : AnyObject], fileURL: NSURL) {
-    guard let jsonString = jsonObjectToString(jsonObject) else {
+public func writeMovingImagesJSONObject(jsonObject: [NSString : AnyObject], fileURL: NSURL,
+                                        options: MIJSONWriterOptions? = .None) {
+    let optionalJSONString: String?
+    if let options = options {
+        optionalJSONString = jsonObjectToString(jsonObject, options: options)
+    }
+    else {
+        optionalJSONString = jsonObjectToString(jsonObject)
+    }
+    guard let jsonString = optionalJSONString else {
         return
     }
     
@@ -342,6 +353,27 @@ internal func makeMILinearGradientDictionary(colors colors: [CGColor],
     return theDict
 }
 
+internal func makeMIRadialGradientDictionary(colors colors: [CGColor],
+                                                 locations: [CGFloat],
+                                                focalPoint: CGPoint,
+                                               centerPoint: CGPoint,
+                                                    radius: CGFloat) -> MovingImagesGradient {
+    var theDict: MovingImagesGradient = [
+        MIJSONKeyElementType : MIJSONValueRadialGradientFill,
+        MIJSONKeyCenterPoint : makePointDictionary(focalPoint),
+        MIJSONKeyRadius : 0.0,
+        MIJSONKeyCenterPoint2 : makePointDictionary(centerPoint),
+        MIJSONKeyRadius2 : radius,
+        MIJSONKeyArrayOfLocations : locations,
+    ]
+    
+    let colorDicts = colors.map() {
+        return SVGColors.makeMIColorFromColor($0)
+    }
+    theDict[MIJSONKeyArrayOfColors] = colorDicts
+    return theDict
+}
+
 public func makeMIDemoObjectFromJSONObject(jsonObject: [NSString : AnyObject]) -> [NSString : AnyObject]? {
     guard let viewBox = jsonObject["viewBox"] as? [NSString : AnyObject],
         let size = viewBox[MIJSONKeySize] as? [NSString : AnyObject],
@@ -0,0 +1,114 @@
+//
+//  MIPathFromSVGPathTests.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+import XCTest
+@testable import SwiftSVG
+
+private func endPointOfElement(element: AnyObject) -> CGPoint? {
+    guard let element = element as? [String : AnyObject],
+        let endPoint = element[MIJSONKeyEndPoint] as? [String : AnyObject],
+        let x = endPoint[MIJSONKeyX] as? CGFloat,
+        let y = endPoint[MIJSONKeyY] as? CGFloat else {
+        return .None
+    }
+    return CGPoint(x: x, y: y)
+}
+
+private func curvesInPathArray(pathArray: NSMutableArray) -> [[String : AnyObject]] {
+    return pathArray.flatMap() {
+        guard let element = $0 as? [String : AnyObject],
+            let elementType = element[MIJSONKeyElementType] as? String
+            where elementType == MIJSONValuePathBezierCurve else {
+            return .None
+        }
+        return element
+    }
+}
+
+private func pointFromDictionary(dictionary: AnyObject?) -> CGPoint {
+    let dictionary = dictionary as! [String : AnyObject]
+    return CGPoint(x: dictionary[MIJSONKeyX] as! CGFloat, y: dictionary[MIJSONKeyY] as! CGFloat)
+}
+
+class MIPathFromSVGPathTests: XCTestCase {
+    override func setUp() {
+        super.setUp()
+        // Put setup code here. This method is called before the invocation of each test method in the class.
+    }
+
+    override func tearDown() {
+        // Put teardown code here. This method is called after the invocation of each test method in the class.
+        super.tearDown()
+    }
+
+    func testRelativeSmoothQuadraticCurve() {
+        var pathArray = NSMutableArray()
+        let path = MICGPathCreateFromSVGPath("M 10 20 Q 20 30 30 20 t 10 5", pathArray: &pathArray)
+        XCTAssert(CGPathGetCurrentPoint(path) == CGPoint(x: 40, y: 25), "The path should end at 40, 25")
+        let endPoint = endPointOfElement(pathArray.lastObject!)
+        XCTAssert(endPoint == CGPoint(x: 40, y: 25), "The t element should end at 40, 25 and ends at \(endPoint)")
+    }
+
+    func testRelativeArcEndsAtEndPoint() {
+        var pathArray = NSMutableArray()
+        let path = MICGPathCreateFromSVGPath("M 10 10 a 5 5 0 0 1 10 0", pathArray: &pathArray)
+        let current = CGPathGetCurrentPoint(path)
+        XCTAssert(abs(current.x - 20.0) < 1.0e-9 && abs(current.y - 10.0) < 1.0e-9,
+                  "The relative arc should end at 20, 10 and ends at \(current)")
+        guard let endPoint = endPointOfElement(pathArray.lastObject!) else {
+            XCTAssert(false, "The arc should add curve elements")
+            return
+        }
+        XCTAssert(abs(endPoint.x - 20.0) < 1.0e-9 && abs(endPoint.y - 10.0) < 1.0e-9,
+                  "The relative arc elements should end at 20, 10 and end at \(endPoint)")
+    }
+
+    func testArcSegmentsFollowTolerance() {
+        let semicircle = "M 0 0 A 100 100 0 0 1 200 0"
+        let center = CGPoint(x: 100, y: 0)
+        var previousCount = 0
+        for tolerance: CGFloat in [1.0, 0.01, 0.0001] {
+            var pathArray = NSMutableArray()
+            MICGPathCreateFromSVGPath(semicircle, pathArray: &pathArray, tolerance: tolerance)
+            let curves = curvesInPathArray(pathArray)
+            XCTAssert(curves.count > previousCount, "A smaller tolerance should need more curves")
+            previousCount = curves.count
+
+            var start = CGPoint.zero
+            var maxError: CGFloat = 0.0
+            for curve in curves {
+                let p1 = pointFromDictionary(curve[MIJSONKeyControlPoint1])
+                let p2 = pointFromDictionary(curve[MIJSONKeyControlPoint2])
+                let p3 = pointFromDictionary(curve[MIJSONKeyEndPoint])
+                for step in 0...32 {
+                    let t = CGFloat(step) / 32.0
+                    let mt = 1.0 - t
+                    let x = mt * mt * mt * start.x + 3.0 * mt * mt * t * p1.x + 3.0 * mt * t * t * p2.x + t * t * t * p3.x
+                    let y = mt * mt * mt * start.y + 3.0 * mt * mt * t * p1.y + 3.0 * mt * t * t * p2.y + t * t * t * p3.y
+                    maxError = max(maxError, abs(hypot(x - center.x, y - center.y) - 100.0))
+                }
+                start = p3
+            }
+            XCTAssert(maxError <= tolerance, "Error \(maxError) should be within tolerance \(tolerance)")
+        }
+
+        var smallArcArray = NSMutableArray()
+        MICGPathCreateFromSVGPath("M 0 0 A 0.5 0.5 0 0 1 1 0", pathArray: &smallArcArray)
+        XCTAssert(curvesInPathArray(smallArcArray).count == 1, "A small semicircle should need a single curve")
+    }
+
+    func testPathWithoutElementArray() {
+        let d = "M 10 10 h 20 v 20 a 10 10 0 1 0 -20 0 s 5 5 10 0 t 10 5 z"
+        var pathArray = NSMutableArray()
+        let pathWithElements = MICGPathCreateFromSVGPath(d, pathArray: &pathArray)
+        let path = MICGPathCreateFromSVGPath(d)
+        XCTAssert(CGPathEqualToPath(path, pathWithElements), "The path should not depend on the element array")
+    }
+}
@@ -213,6 +213,85 @@ class MovingImagesSVGTests: XCTestCase {
         } catch { }
     }
     
+    func testDisplayListReplayMatchesRender() {
+        guard let xmlDocument = try? xmlDocumentFromNamedSVGFile("Ghostscript_Tiger"),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+
+        let renderer = MovingImagesRenderer()
+        let _ = try? SVGRenderer().renderDocument(svgDocument, renderer: renderer)
+
+        guard let displayList = try? svgDocument.displayList() else {
+            XCTAssert(false, "Failed to compile the display list")
+            return
+        }
+        let replayRenderer = MovingImagesRenderer()
+        let _ = try? displayList.replay(replayRenderer)
+        XCTAssert(renderer.render() == replayRenderer.render(),
+            "Replaying the display list should produce the same JSON as rendering the document")
+
+        let sameDisplayList = try? svgDocument.displayList()
+        XCTAssert(sameDisplayList === displayList, "Display list should be reused while the document is unchanged")
+        svgDocument.optimise()
+        let newDisplayList = try? svgDocument.displayList()
+        XCTAssert(newDisplayList !== displayList, "Display list should be recompiled after the document changes")
+    }
+
+    func testNumberFormatter() {
+        let shortest = SVGNumberFormatter()
+        XCTAssert(shortest.format(0.1) == "0.1", "0.1 should be written as 0.1")
+        XCTAssert(shortest.format(0.1 + 0.2) == "0.30000000000000004", "Formatting should round trip")
+        XCTAssert(shortest.format(-12.0) == "-12", "Whole numbers should be written as integers")
+        XCTAssert(shortest.format(-0.125) == "-0.125" && shortest.format(12.375) == "12.375",
+                  "Short decimals should be written exactly")
+        XCTAssert(shortest.format(0.00001) == "1e-05", "Small values should keep the exponent form")
+
+        let twoPlaces = SVGNumberFormatter(precision: .decimalPlaces(2))
+        XCTAssert(twoPlaces.format(3.14159) == "3.14", "3.14159 should be written as 3.14")
+        XCTAssert(twoPlaces.format(-3.14159) == "-3.14", "Rounding should keep the sign")
+        XCTAssert(twoPlaces.format(-0.004) == "0", "Values rounding to zero should be written as 0")
+        XCTAssert(twoPlaces.format(2.5) == "2.5", "Trailing zeros should be dropped")
+        XCTAssert(twoPlaces.format(0.05) == "0.05", "Leading fraction zeros should be kept")
+
+        let quarters = SVGNumberFormatter(precision: .quantum(0.25))
+        XCTAssert(quarters.format(1.3) == "1.25", "1.3 should snap to 1.25")
+        XCTAssert(quarters.format(1.9) == "2", "1.9 should snap to 2")
+    }
+
+    func testCompactJSON() {
+        guard let xmlDocument = try? xmlDocumentFromNamedSVGFile("Ghostscript_Tiger"),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        let renderer = MovingImagesRenderer()
+        let _ = try? SVGRenderer().renderDocument(svgDocument, renderer: renderer)
+
+        var options = MIJSONWriterOptions()
+        let fullJSON = renderer.render(options)
+        options.precision = .decimalPlaces(2)
+        options.relativePathData = true
+        let compactJSON = renderer.render(options)
+        XCTAssert(compactJSON.utf8.count < fullJSON.utf8.count,
+                  "Rounded relative JSON should be smaller: \(compactJSON.utf8.count) vs \(fullJSON.utf8.count)")
+        XCTAssert(fullJSON.utf8.count < renderer.render().utf8.count, "Compact JSON should be smaller than pretty printed JSON")
+
+        guard let data = compactJSON.dataUsingEncoding(NSUTF8StringEncoding),
+            let jsonObject = try? NSJSONSerialization.JSONObjectWithData(data, options: []),
+            let fullData = fullJSON.dataUsingEncoding(NSUTF8StringEncoding),
+            let fullJSONObject = try? NSJSONSerialization.JSONObjectWithData(fullData, options: []) else {
+            XCTAssert(false, "The written JSON should parse")
+            return
+        }
+        XCTAssert(fullJSONObject.isEqual(renderer.generateJSONDict()), "Full precision JSON should read back unchanged")
+        let elements = (jsonObject as? NSDictionary)?.objectForKey(MIJSONKeyArrayOfElements) as? NSArray
+        XCTAssert(elements != nil, "The compact JSON should have the same structure")
+    }
+
     func testTextDrawing() {
         let jsonString: String
         let originalJSONString: String
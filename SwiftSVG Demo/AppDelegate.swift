@@ -75,16 +75,8 @@ class AppDelegate: NSObject, NSApplicationDelegate {
                     let svgFileName = svgFileURL.lastPathComponent!
                     let movingImagesFile = svgFileName.stringByReplacingOccurrencesOfString(".svg", withString: ".json")
                     let newFileURL = destFolder.URLByAppendingPathComponent(movingImagesFile)
-                    var encoding = NSStringEncoding()
-                    guard let source = try? String(contentsOfURL: svgFileURL, usedEncoding: &encoding) else {
-                        return
-                    }
-                    guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0) else {
-                        return
-                    }
-                    
                     let processor = SVGProcessor()
-                    guard let tempDocument = try? processor.processXMLDocument(xmlDocument) else {
+                    guard let tempDocument = try? processor.processFileURL(svgFileURL) else {
                         return
                     }
                     guard let svgDocument = tempDocument else {
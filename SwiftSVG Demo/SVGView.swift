@@ -18,12 +18,39 @@ class SVGView: NSView {
 
     var svgRenderer: SVGRenderer = SVGRenderer()
 
+    /// Paths are drawn simplified when zoomed out.
+    let levelOfDetail = SVGLevelOfDetail()
+
+    /// The display list whose levels of detail have been built.
+    private var preparedDisplayList: SVGDisplayList? = nil
+
+    /// When true groups are drawn from bitmaps that are kept while panning
+    /// and zooming, rather than rendered on every redraw.
+    var usesLayerCache = true {
+        didSet {
+            layerCache.removeAll()
+            needsDisplay = true
+        }
+    }
+
+    let layerCache = SVGLayerCache()
+
+    /// The snapshot of the document the layers are drawn from.
+    private var frozenDocument: (generation: Int, frozenDocument: SVGFrozenDocument)? = nil
+
+    /// The checkerboard is only generated again when the view's size changes.
+    private var checkerboard: (size: CGSize, image: CGImage)? = nil
+
     var svgDocument: SVGDocument? = nil {
         didSet {
             if let svgDocument = svgDocument, let viewBox = svgDocument.viewBox {
                 horizontalConstraint?.constant = viewBox.width
                 verticalConstraint?.constant = viewBox.height
             }
+            levelOfDetail.removeAll()
+            layerCache.removeAll()
+            frozenDocument = nil
+            preparedDisplayList = nil
             needsDisplay = true
             needsLayout = true
         }
@@ -42,28 +69,76 @@ class SVGView: NSView {
         let context = NSGraphicsContext.currentContext()!.CGContext
         CGContextSetTextMatrix(context, CGAffineTransformIdentity)
 
-        // Drawing code here.
-        let filter = CheckerboardGenerator()
-        filter.inputCenter = CIVector(CGPoint: CGPointZero)
-        filter.inputWidth = 20
-        filter.inputColor0 = CIColor(CGColor: CGColor.whiteColor())
-        filter.inputColor1 = CIColor(CGColor: CGColor.color(white: 0.8, alpha: 1))
-        let ciImage = filter.outputImage!
-        let ciContext = CIContext(CGContext: context, options: nil)
-        let image = ciContext.createCGImage(ciImage, fromRect: bounds)
-        CGContextDrawImage(context, bounds, image)
+        CGContextDrawImage(context, bounds, checkerboardImage())
 
         if let svgDocument = svgDocument {
             context.with() {
                 CGContextScaleCTM(context, 1, -1)
                 CGContextTranslateCTM(context, 0, -bounds.size.height)
-                try! svgRenderer.renderDocument(svgDocument, renderer: context)
+                let prerenderElement = svgRenderer.callbacks.prerenderElement
+                if svgRenderer.stroker != nil {
+                    // Outlined strokes depend on the scale the view draws at,
+                    // so the document is drawn directly rather than from a
+                    // display list.
+                    let transform = CGContextGetUserSpaceToDeviceSpaceTransform(context)
+                    svgRenderer.strokeScale = sqrt(abs(transform.a * transform.d - transform.b * transform.c))
+                    try! svgRenderer.renderDocument(svgDocument, renderer: context)
+                }
+                else {
+                    // The snapshot is only taken again when the document
+                    // changes. Levels of detail are built from it in the
+                    // background, as unlike the document's elements its paths
+                    // are all built already.
+                    if frozenDocument?.generation != svgDocument.generation {
+                        frozenDocument = (generation: svgDocument.generation, frozenDocument: try! svgDocument.freeze())
+                    }
+                    let snapshot = frozenDocument!.frozenDocument
+                    prepareLevelOfDetail(snapshot.displayList)
+                    if usesLayerCache {
+                        try! layerCache.draw(snapshot, context: context, levelOfDetail: levelOfDetail,
+                                             prerenderElement: prerenderElement)
+                    }
+                    else {
+                        try! snapshot.displayList.replay(context, levelOfDetail: levelOfDetail,
+                                                         deviceTransform: CGContextGetCTM(context),
+                                                         prerenderElement: prerenderElement)
+                    }
+                }
             }
         }
 
         CGContextStrokeRect(context, bounds)
     }
 
+    private func checkerboardImage() -> CGImage {
+        if let checkerboard = checkerboard where checkerboard.size == bounds.size {
+            return checkerboard.image
+        }
+        let filter = CheckerboardGenerator()
+        filter.inputCenter = CIVector(CGPoint: CGPointZero)
+        filter.inputWidth = 20
+        filter.inputColor0 = CIColor(CGColor: CGColor.whiteColor())
+        filter.inputColor1 = CIColor(CGColor: CGColor.color(white: 0.8, alpha: 1))
+        let ciImage = filter.outputImage!
+        let image = CIContext(options: nil).createCGImage(ciImage, fromRect: bounds)
+        checkerboard = (size: bounds.size, image: image)
+        return image
+    }
+
+    private func prepareLevelOfDetail(displayList: SVGDisplayList) {
+        if preparedDisplayList === displayList {
+            return
+        }
+        // Until the levels are built in the background they are built as
+        // they are drawn. Levels a prepare builds after the document changes
+        // are dropped, as removeAll starts a new generation of levels.
+        preparedDisplayList = displayList
+        let levelOfDetail = self.levelOfDetail
+        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0)) {
+            levelOfDetail.prepare(displayList)
+        }
+    }
+
     deinit {
         Swift.print("SVGView deinited")
     }
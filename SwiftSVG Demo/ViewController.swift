@@ -69,6 +69,8 @@ class ViewController: NSViewController {
                     return $0.object as! SVGElement
                 }
                 self.selectedElements = Set <SVGElement> (selectedElements)
+                // Selected elements are highlighted in the cached layers.
+                svgView.layerCache.removeAll()
                 svgView.needsDisplay = true
             }
         }
@@ -76,6 +78,14 @@ class ViewController: NSViewController {
 
     var summaryViewController: SummaryViewController!
 
+    /// Kept between parses so that editing the source only reprocesses the
+    /// parts that changed.
+    let processor: SVGProcessor = {
+        let processor = SVGProcessor()
+        processor.incremental = true
+        return processor
+    }()
+
     var selectedElements: Set <SVGElement> = Set <SVGElement> ()
 
     override func viewDidLoad() {
@@ -127,7 +137,13 @@ class ViewController: NSViewController {
         }
 
         let xmlDocument = try NSXMLDocument(XMLString: source, options: 0)
-        let processor = SVGProcessor()
+        defer {
+            // The processor empties the previous document when it reuses its
+            // elements, even if processing the new one then fails.
+            if svgDocument?.isInvalidated ?? false {
+                svgDocument = nil
+            }
+        }
         svgDocument = try processor.processXMLDocument(xmlDocument)
     }
 
@@ -225,6 +241,8 @@ class ViewController: NSViewController {
                     return "Line"
                 case is SVGSimpleText:
                     return "Text"
+                case is SVGUse:
+                    return "Use"
                 default:
                     preconditionFailure()
             }
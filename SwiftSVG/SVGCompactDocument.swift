@@ -0,0 +1,401 @@
+//
+//  SVGCompactDocument.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+import SwiftGraphics
+
+/// One element of an SVGCompactDocument. Links to other nodes, styles,
+/// transforms and paths are indices into the document's arrays, with -1 for
+/// none.
+public struct SVGCompactNode {
+    public enum Kind: UInt8 {
+        case document
+        case group
+        case use
+        case path
+        case line
+        case polygon
+        case polyline
+        case rect
+        case ellipse
+        case circle
+        case text
+    }
+
+    public struct Flags: OptionSetType {
+        public let rawValue: UInt8
+        public init(rawValue: UInt8) {
+            self.rawValue = rawValue
+        }
+        public static let display = Flags(rawValue: 1 << 0)
+        public static let drawFill = Flags(rawValue: 1 << 1)
+        public static let evenOdd = Flags(rawValue: 1 << 2)
+    }
+
+    public let kind: Kind
+    public let flags: Flags
+    public internal(set) var parent: Int32
+    public internal(set) var firstChild: Int32
+    public internal(set) var nextSibling: Int32
+    /// For a shape the index of its path, for a use element the index of
+    /// the node it instances.
+    public internal(set) var content: Int32
+    public internal(set) var style: Int32
+    public internal(set) var transform: Int32
+}
+
+/// An index based copy of a document's element tree. Nodes are kept in one
+/// contiguous array linked by parent, first child and next sibling indices,
+/// and distinct styles and paths are shared. Attributes few elements have,
+/// like ids, gradient fills and text, are kept in side tables keyed by node
+/// index.
+///
+/// There are no per element objects, so releasing the compact document
+/// frees the whole tree at once. It can be rendered with
+/// SVGRenderer.renderCompactDocument after the element tree has been
+/// released. Elements referenced by use elements that are not part of the
+/// tree are added as extra roots after it.
+public final class SVGCompactDocument {
+    public let viewBox: CGRect?
+    public private(set) var nodes = [SVGCompactNode]()
+    public private(set) var styles = [Style]()
+    public private(set) var transforms = [CGAffineTransform]()
+    public private(set) var paths = [CGPath]()
+
+    public private(set) var ids = [Int32: String]()
+    /// The path data of path elements, by path index.
+    public private(set) var pathData = [Int32: String]()
+    /// Gradient fills resolved against the bounds of the element they fill.
+    public private(set) var linearGradientFills = [Int32: SVGLinearGradientFill]()
+    public private(set) var radialGradientFills = [Int32: SVGRadialGradientFill]()
+    public private(set) var textStyles = [Int32: TextStyle]()
+    public private(set) var texts = [Int32: SVGSimpleText]()
+    public private(set) var unhandledAttributes = [Int32: [String: String]]()
+
+    private var nodeIndices = [ObjectIdentifier: Int32]()
+    private var styleIndices = [SVGStyleKey: Int32]()
+    private var pathIndices = [ObjectIdentifier: Int32]()
+
+    public init(svgDocument: SVGDocument) {
+        viewBox = svgDocument.viewBox
+        addNode(svgDocument, parent: -1)
+        // Referenced elements are shared so each is copied once.
+        var index = 0
+        while index < nodes.count {
+            if nodes[index].kind == .use, let use = uses[Int32(index)] {
+                nodes[index].content = nodeIndices[ObjectIdentifier(use.referencedElement)]
+                    ?? addNode(use.referencedElement, parent: -1)
+            }
+            index += 1
+        }
+        uses = [: ]
+        nodeIndices = [: ]
+        styleIndices = [: ]
+        pathIndices = [: ]
+    }
+
+    public var rootIndex: Int {
+        return 0
+    }
+
+    /// The indices of the children of the node at index, in order.
+    public func childIndices(index: Int) -> [Int] {
+        var indices = [Int]()
+        var child = nodes[index].firstChild
+        while child >= 0 {
+            indices.append(Int(child))
+            child = nodes[Int(child)].nextSibling
+        }
+        return indices
+    }
+
+    public func id(index: Int) -> String? {
+        return ids[Int32(index)]
+    }
+
+    /// The approximate number of bytes held by the document, counting its
+    /// arrays and side tables and what they refer to: the points of each
+    /// path, path data, text and gradients. Objects shared between nodes are
+    /// counted once.
+    public var byteCount: Int {
+        // A dictionary entry is counted as its key and value plus a slot's
+        // worth of overhead.
+        func tableBytes<Value>(table: [Int32: Value]) -> Int {
+            return table.count * (strideof(Int32) + strideof(Value) + strideof(Int)) * 2
+        }
+        var count = nodes.count * strideof(SVGCompactNode)
+        count += styles.count * strideof(Style)
+        count += transforms.count * strideof(CGAffineTransform)
+        count += paths.count * strideof(CGPath)
+        count += tableBytes(ids) + tableBytes(pathData) + tableBytes(linearGradientFills)
+        count += tableBytes(radialGradientFills) + tableBytes(textStyles) + tableBytes(texts)
+        count += tableBytes(unhandledAttributes)
+
+        var payload = SVGPayloadBytes()
+        paths.forEach() { payload.addPath($0) }
+        ids.values.forEach() { payload.addString($0) }
+        pathData.values.forEach() { payload.addString($0) }
+        linearGradientFills.values.forEach() { payload.addGradient($0.gradient, fill: $0) }
+        radialGradientFills.values.forEach() { payload.addGradient($0.gradient, fill: $0) }
+        texts.values.forEach() { payload.addText($0) }
+        return count + payload.byteCount
+    }
+
+    public var bytesPerElement: Double {
+        return nodes.isEmpty ? 0.0 : Double(byteCount) / Double(nodes.count)
+    }
+
+    // MARK: -
+
+    private var uses = [Int32: SVGUse]()
+
+    private func addNode(element: SVGElement, parent: Int32) -> Int32 {
+        let index = Int32(nodes.count)
+        nodeIndices[ObjectIdentifier(element)] = index
+
+        var flags = SVGCompactNode.Flags()
+        if element.display {
+            flags.insert(.display)
+        }
+        if element.drawFill {
+            flags.insert(.drawFill)
+        }
+        if let pathGenerator = element as? PathGenerator where pathGenerator.evenOdd {
+            flags.insert(.evenOdd)
+        }
+
+        var content: Int32 = -1
+        let kind: SVGCompactNode.Kind
+        switch element {
+            case is SVGDocument:
+                kind = .document
+            case is SVGUse:
+                kind = .use
+                uses[index] = element as? SVGUse
+            case let text as SVGSimpleText:
+                kind = .text
+                // Spans find their font and colors through the element tree,
+                // which may be released before the compact document is drawn.
+                for span in text.spans {
+                    _ = span.cttext
+                    _ = span.mitext
+                    _ = span.textOrigin
+                }
+                texts[index] = text
+            case is SVGPath:
+                kind = .path
+            case is SVGLine:
+                kind = .line
+            case is SVGPolygon:
+                kind = .polygon
+            case is SVGPolyline:
+                kind = .polyline
+            case is SVGRect:
+                kind = .rect
+            case is SVGEllipse:
+                kind = .ellipse
+            case is SVGCircle:
+                kind = .circle
+            default:
+                kind = .group
+        }
+        if let pathGenerator = element as? PathGenerator {
+            // Path elements with the same path data share one CGPath.
+            let path = pathGenerator.cgpath
+            if let pathIndex = pathIndices[ObjectIdentifier(path)] {
+                content = pathIndex
+            }
+            else {
+                content = Int32(paths.count)
+                pathIndices[ObjectIdentifier(path)] = content
+                paths.append(path)
+                if let svgPath = element as? SVGPath, let svgpath = svgPath.svgpath {
+                    pathData[content] = svgpath
+                }
+            }
+        }
+
+        var style: Int32 = -1
+        if let elementStyle = element.style {
+            // Documents use a handful of distinct styles so share them.
+            let key = SVGStyleKey(style: elementStyle)
+            if let styleIndex = styleIndices[key] {
+                style = styleIndex
+            }
+            else {
+                style = Int32(styles.count)
+                styleIndices[key] = style
+                styles.append(elementStyle)
+            }
+        }
+        var transform: Int32 = -1
+        if let elementTransform = element.transform {
+            transform = Int32(transforms.count)
+            transforms.append(elementTransform.toCGAffineTransform())
+        }
+
+        if let id = element.id {
+            ids[index] = id
+        }
+        // Resolved now, as the bounds of the element they fill are needed.
+        if let linearGradientFill = element.linearGradientFill {
+            _ = linearGradientFill.startPoint
+            _ = linearGradientFill.endPoint
+            _ = linearGradientFill.miLinearGradient
+            linearGradientFills[index] = linearGradientFill
+        }
+        else if let radialGradientFill = element.radialGradientFill {
+            _ = radialGradientFill.gradientTransform
+            _ = radialGradientFill.miRadialGradient
+            radialGradientFills[index] = radialGradientFill
+        }
+        if let textStyle = element.textStyle {
+            textStyles[index] = textStyle
+        }
+        if let attributes = element.unhandledAttributes {
+            unhandledAttributes[index] = attributes
+        }
+
+        nodes.append(SVGCompactNode(kind: kind, flags: flags, parent: parent, firstChild: -1, nextSibling: -1,
+                                    content: content, style: style, transform: transform))
+
+        if let container = element as? SVGContainer {
+            var previous: Int32 = -1
+            for child in container.children {
+                let childIndex = addNode(child, parent: index)
+                if previous < 0 {
+                    nodes[Int(index)].firstChild = childIndex
+                }
+                else {
+                    nodes[Int(previous)].nextSibling = childIndex
+                }
+                previous = childIndex
+            }
+        }
+        return index
+    }
+}
+
+/// A style as a dictionary key, so that a style is shared without comparing
+/// it with every distinct style so far.
+internal struct SVGStyleKey: Hashable {
+    let style: Style
+
+    var hashValue: Int {
+        var hash = style.lineWidth?.hashValue ?? 0
+        for component in (style.fillColor?.components ?? []) + (style.strokeColor?.components ?? []) {
+            hash = hash &* 31 &+ component.hashValue
+        }
+        return hash
+    }
+}
+
+internal func == (lhs: SVGStyleKey, rhs: SVGStyleKey) -> Bool {
+    return lhs.style == rhs.style
+}
+
+/// Adds up the bytes of what elements and compact nodes refer to. Each
+/// object is counted once however many refer to it.
+internal struct SVGPayloadBytes {
+    private(set) var byteCount = 0
+    private var counted = Set<ObjectIdentifier>()
+
+    /// A CGPath as its object plus a verb and its points for each segment.
+    /// Returns false if path has been counted already.
+    mutating func addPath(path: CGPath) -> Bool {
+        guard addObject(path) else {
+            return false
+        }
+        let geometry = SVGPathGeometry(path: path)
+        byteCount += geometry.verbs.count * strideof(SVGPathGeometry.Verb)
+        byteCount += geometry.points.count * strideof(CGPoint)
+        return true
+    }
+
+    mutating func addString(string: String) {
+        byteCount += string.utf8.count
+    }
+
+    mutating func addText(text: SVGSimpleText) {
+        if addObject(text) {
+            for span in text.spans {
+                if addObject(span) {
+                    byteCount += CFStringGetLength(span.string) * strideof(UniChar)
+                }
+            }
+        }
+    }
+
+    mutating func addGradient(gradient: SVGGradient, fill: AnyObject? = .None) {
+        if let fill = fill {
+            addObject(fill)
+        }
+        if addObject(gradient) {
+            byteCount += (gradient.stops?.count ?? 0) * strideof(SVGGradientStop)
+        }
+    }
+
+    /// Returns false if object has been counted already.
+    mutating func addObject(object: AnyObject) -> Bool {
+        guard !counted.contains(ObjectIdentifier(object)) else {
+            return false
+        }
+        counted.insert(ObjectIdentifier(object))
+        byteCount += malloc_size(unsafeAddressOf(object))
+        return true
+    }
+}
+
+// MARK: -
+
+public extension SVGDocument {
+    /// The number of elements in the document and the bytes allocated for
+    /// their objects and what they refer to, counted the same way as
+    /// SVGCompactDocument.byteCount.
+    func elementAllocationStatistics() -> (elementCount: Int, byteCount: Int) {
+        var visited = Set<ObjectIdentifier>()
+        var byteCount = 0
+        var payload = SVGPayloadBytes()
+        func visit(element: SVGElement) {
+            guard !visited.contains(ObjectIdentifier(element)) else {
+                return
+            }
+            visited.insert(ObjectIdentifier(element))
+            payload.addObject(element)
+            if let id = element.id {
+                payload.addString(id)
+            }
+            if let pathGenerator = element as? PathGenerator {
+                // The path data of shared paths is shared too.
+                if payload.addPath(pathGenerator.cgpath), let svgPath = element as? SVGPath,
+                    let svgpath = svgPath.svgpath {
+                    payload.addString(svgpath)
+                }
+            }
+            if let gradientFill = element.linearGradientFill {
+                payload.addGradient(gradientFill.gradient, fill: gradientFill)
+            }
+            else if let gradientFill = element.radialGradientFill {
+                payload.addGradient(gradientFill.gradient, fill: gradientFill)
+            }
+            if let text = element as? SVGSimpleText {
+                payload.addText(text)
+            }
+            if let container = element as? SVGContainer {
+                byteCount += container.children.count * strideof(SVGElement)
+                container.children.forEach(visit)
+            }
+            if let use = element as? SVGUse {
+                visit(use.referencedElement)
+            }
+        }
+        visit(self)
+        return (elementCount: visited.count, byteCount: byteCount + payload.byteCount)
+    }
+}
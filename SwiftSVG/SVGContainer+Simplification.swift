@@ -0,0 +1,327 @@
+//
+//  SVGContainer+Simplification.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+/// What a simplification pass removed. Path data lengths are of the
+/// geometry written as SVG path data, before and after.
+public struct SVGSimplificationReport: CustomStringConvertible {
+    public var elementCount = 0
+    public var simplifiedElementCount = 0
+    public var vertexCount = 0
+    public var simplifiedVertexCount = 0
+    public var pathDataLength = 0
+    public var simplifiedPathDataLength = 0
+
+    public var description: String {
+        return "Simplified \(simplifiedElementCount) of \(elementCount) elements, " +
+            "vertices \(vertexCount) -> \(simplifiedVertexCount), " +
+            "path data \(pathDataLength) -> \(simplifiedPathDataLength) bytes"
+    }
+}
+
+public extension SVGContainer {
+
+    /// Removes vertices from polylines, polygons and the straight line runs
+    /// of paths using Douglas-Peucker, so that no outline moves by more than
+    /// tolerance. Curves are kept as they are, unless flattensCurves is true,
+    /// when paths are simplified from their polyline form. That form moves the
+    /// outline by up to the arc tolerance the document was processed with as
+    /// well.
+    ///
+    /// The tolerance is measured after transform is applied to the
+    /// container's coordinates. Pass the identity for a tolerance in user
+    /// units, or the transform to the output bitmap for one in output pixels.
+    /// Each element's tolerance is scaled by its own transforms.
+    ///
+    /// A closed ring keeps at least three vertices so it never collapses to a
+    /// line or a point. Rings are not tested for self intersection.
+    ///
+    /// Elements are simplified in parallel.
+    func simplify(tolerance: CGFloat, transform: CGAffineTransform = CGAffineTransformIdentity,
+                  flattensCurves: Bool = false) -> SVGSimplificationReport {
+        var candidates = [(element: SVGElement, tolerance: CGFloat)]()
+        collectSimplifiableElements(self, tolerance: tolerance, transform: transform, candidates: &candidates)
+
+        // The geometry is simplified concurrently. Only the replacing is done
+        // on this thread as changing an element notifies its ancestors.
+        var results = [SimplifiedGeometry?](count: candidates.count, repeatedValue: .None)
+        results.withUnsafeMutableBufferPointer() {
+            (inout buffer: UnsafeMutableBufferPointer<SimplifiedGeometry?>) -> Void in
+            let resultsPointer = buffer.baseAddress
+            let queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0)
+            dispatch_apply(candidates.count, queue) { index in
+                let candidate = candidates[index]
+                resultsPointer[index] = simplifyElement(candidate.element, tolerance: candidate.tolerance,
+                                                       flattensCurves: flattensCurves)
+            }
+        }
+
+        var report = SVGSimplificationReport()
+        report.elementCount = candidates.count
+        for (candidate, result) in zip(candidates, results) {
+            guard let result = result else {
+                continue
+            }
+            report.vertexCount += result.vertexCount
+            report.simplifiedVertexCount += result.simplified.points.count
+            report.pathDataLength += result.pathDataLength
+            // A flattened curve can come back with more vertices than it had.
+            if result.simplified.points.count >= result.vertexCount {
+                report.simplifiedPathDataLength += result.pathDataLength
+                continue
+            }
+            report.simplifiedElementCount += 1
+            switch candidate.element {
+                case let path as SVGPath:
+                    path.replaceGeometry(result.simplified)
+                    report.simplifiedPathDataLength += path.svgpath?.utf8.count ?? 0
+                case let polygon as SVGPolygon:
+                    polygon.replacePoints(result.simplified.points)
+                    report.simplifiedPathDataLength += result.simplified.svgPath.utf8.count
+                case let polyline as SVGPolyline:
+                    polyline.replacePoints(result.simplified.points)
+                    report.simplifiedPathDataLength += result.simplified.svgPath.utf8.count
+                default:
+                    break
+            }
+        }
+        SVGLog.debug("\(report)")
+        return report
+    }
+}
+
+// MARK: -
+
+private struct SimplifiedGeometry {
+    let simplified: SVGPathGeometry
+    let vertexCount: Int
+    let pathDataLength: Int
+}
+
+private func collectSimplifiableElements(container: SVGContainer, tolerance: CGFloat, transform: CGAffineTransform,
+                                         inout candidates: [(element: SVGElement, tolerance: CGFloat)]) {
+    for child in container.children {
+        var childTransform = transform
+        if let elementTransform = child.transform {
+            childTransform = CGAffineTransformConcat(elementTransform.toCGAffineTransform(), transform)
+        }
+        switch child {
+            case let childContainer as SVGContainer:
+                collectSimplifiableElements(childContainer, tolerance: tolerance, transform: childTransform,
+                                            candidates: &candidates)
+            case is SVGPath, is SVGPolygon, is SVGPolyline:
+                // Dividing by the largest scale of the transform keeps the
+                // error within tolerance in every direction.
+                let scale = maximumScale(childTransform)
+                if scale > 0.0 {
+                    candidates.append((element: child, tolerance: tolerance / scale))
+                }
+            default:
+                break
+        }
+    }
+}
+
+/// The most transform stretches any direction by.
+internal func maximumScale(transform: CGAffineTransform) -> CGFloat {
+    let (a, b, c, d) = (transform.a, transform.b, transform.c, transform.d)
+    let sumOfSquares = 0.5 * (a * a + b * b + c * c + d * d)
+    let difference = 0.5 * (a * a + b * b - c * c - d * d)
+    let product = a * c + b * d
+    return sqrt(sumOfSquares + sqrt(difference * difference + product * product))
+}
+
+private func simplifyElement(element: SVGElement, tolerance: CGFloat, flattensCurves: Bool) -> SimplifiedGeometry? {
+    let geometry: SVGPathGeometry
+    let simplified: SVGPathGeometry
+    switch element {
+        case let path as SVGPath:
+            geometry = path.source.geometry
+            let lines = flattensCurves ? path.source.polyline : geometry
+            simplified = simplifyPathGeometry(lines, tolerance: tolerance)
+        case let polygon as SVGPolygon:
+            let points = polygon.polygon.points
+            geometry = polylineGeometry(points, closed: true)
+            simplified = polylineGeometry(simplifyRing(points, tolerance: tolerance), closed: true)
+        case let polyline as SVGPolyline:
+            let points = polyline.points
+            geometry = polylineGeometry(points, closed: false)
+            let closed = points.count > 3 && points.first == points.last
+            let simplifiedPoints = closed
+                ? simplifyRing(Array(points.dropLast()), tolerance: tolerance) + [points[0]]
+                : simplifyPolyline(points, tolerance: tolerance)
+            simplified = polylineGeometry(simplifiedPoints, closed: false)
+        default:
+            return .None
+    }
+    let pathDataLength = (element as? SVGPath)?.svgpath?.utf8.count ?? geometry.svgPath.utf8.count
+    return SimplifiedGeometry(simplified: simplified, vertexCount: geometry.points.count,
+                              pathDataLength: pathDataLength)
+}
+
+private func polylineGeometry(points: [CGPoint], closed: Bool) -> SVGPathGeometry {
+    if points.isEmpty {
+        return SVGPathGeometry(verbs: [], points: [])
+    }
+    var verbs = [SVGPathGeometry.Verb](count: points.count, repeatedValue: .lineTo)
+    verbs[0] = .moveTo
+    if closed {
+        verbs.append(.closeSubpath)
+    }
+    return SVGPathGeometry(verbs: verbs, points: points)
+}
+
+/// Simplifies the runs of line segments in a path. A subpath made only of
+/// line segments and closed is simplified as a ring.
+internal func simplifyPathGeometry(geometry: SVGPathGeometry, tolerance: CGFloat) -> SVGPathGeometry {
+    var verbs = [SVGPathGeometry.Verb]()
+    var points = [CGPoint]()
+    verbs.reserveCapacity(geometry.verbs.count)
+    points.reserveCapacity(geometry.points.count)
+
+    // The point the run starts from followed by the end points of its lines.
+    var run = [CGPoint]()
+    var runStartsSubpath = false
+
+    func flushRun(closesSubpath: Bool) {
+        if run.count > 1 {
+            var simplifiedRun: [CGPoint]
+            if closesSubpath && runStartsSubpath {
+                // The close draws the last line back to the start.
+                if run.count > 2 && run.last == run.first {
+                    run.removeLast()
+                }
+                simplifiedRun = simplifyRing(run, tolerance: tolerance)
+            }
+            else {
+                simplifiedRun = simplifyPolyline(run, tolerance: tolerance)
+            }
+            for point in simplifiedRun.dropFirst() {
+                verbs.append(.lineTo)
+                points.append(point)
+            }
+        }
+        run.removeAll(keepCapacity: true)
+    }
+
+    var current = CGPoint.zero
+    var subpathStart = CGPoint.zero
+    var index = 0
+    for verb in geometry.verbs {
+        switch verb {
+            case .lineTo:
+                if run.isEmpty {
+                    run.append(current)
+                    runStartsSubpath = verbs.last == .moveTo
+                }
+                current = geometry.points[index]
+                run.append(current)
+            case .closeSubpath:
+                flushRun(true)
+                verbs.append(verb)
+                current = subpathStart
+            case .moveTo:
+                flushRun(false)
+                current = geometry.points[index]
+                subpathStart = current
+                verbs.append(verb)
+                points.append(current)
+            case .quadCurveTo, .curveTo:
+                flushRun(false)
+                verbs.append(verb)
+                points.appendContentsOf(geometry.points[index..<index + verb.pointCount])
+                current = geometry.points[index + verb.pointCount - 1]
+        }
+        index += verb.pointCount
+    }
+    flushRun(false)
+    return SVGPathGeometry(verbs: verbs, points: points)
+}
+
+/// Douglas-Peucker on an open polyline. The end points are always kept.
+internal func simplifyPolyline(points: [CGPoint], tolerance: CGFloat) -> [CGPoint] {
+    if points.count < 3 {
+        return points
+    }
+    var keep = [Bool](count: points.count, repeatedValue: false)
+    keep[0] = true
+    keep[points.count - 1] = true
+    let toleranceSquared = tolerance * tolerance
+
+    // An explicit stack of ranges rather than recursion, as map outlines can
+    // have many thousands of vertices.
+    var ranges = [(0, points.count - 1)]
+    while let range = ranges.popLast() {
+        let (first, last) = range
+        if last - first < 2 {
+            continue
+        }
+        var farthestIndex = first
+        var farthestDistance: CGFloat = -1.0
+        for index in first + 1 ..< last {
+            let distance = distanceSquared(points[index], segmentStart: points[first], segmentEnd: points[last])
+            if distance > farthestDistance {
+                farthestIndex = index
+                farthestDistance = distance
+            }
+        }
+        if farthestDistance > toleranceSquared {
+            keep[farthestIndex] = true
+            ranges.append((first, farthestIndex))
+            ranges.append((farthestIndex, last))
+        }
+    }
+
+    var simplified = [CGPoint]()
+    for (index, point) in points.enumerate() where keep[index] {
+        simplified.append(point)
+    }
+    return simplified
+}
+
+/// Douglas-Peucker on a closed ring, without a repeated closing point. The
+/// ring is split at its first point and the point farthest from it, and at
+/// least three vertices are kept.
+internal func simplifyRing(points: [CGPoint], tolerance: CGFloat) -> [CGPoint] {
+    if points.count <= 3 {
+        return points
+    }
+    var farthestIndex = 0
+    var farthestDistance: CGFloat = -1.0
+    for (index, point) in points.enumerate() {
+        let dx = point.x - points[0].x
+        let dy = point.y - points[0].y
+        let distance = dx * dx + dy * dy
+        if distance > farthestDistance {
+            farthestIndex = index
+            farthestDistance = distance
+        }
+    }
+    if farthestIndex == 0 {
+        return points
+    }
+    let firstHalf = simplifyPolyline(Array(points[0...farthestIndex]), tolerance: tolerance)
+    let secondHalf = simplifyPolyline(Array(points[farthestIndex..<points.count]) + [points[0]], tolerance: tolerance)
+    let simplified = firstHalf + secondHalf.dropFirst().dropLast()
+    return simplified.count < 3 ? points : simplified
+}
+
+private func distanceSquared(point: CGPoint, segmentStart: CGPoint, segmentEnd: CGPoint) -> CGFloat {
+    let dx = segmentEnd.x - segmentStart.x
+    let dy = segmentEnd.y - segmentStart.y
+    let lengthSquared = dx * dx + dy * dy
+    var t: CGFloat = 0.0
+    if lengthSquared > 0.0 {
+        t = ((point.x - segmentStart.x) * dx + (point.y - segmentStart.y) * dy) / lengthSquared
+        t = min(max(t, 0.0), 1.0)
+    }
+    let x = segmentStart.x + t * dx - point.x
+    let y = segmentStart.y + t * dy - point.y
+    return x * x + y * y
+}
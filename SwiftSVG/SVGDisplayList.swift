@@ -0,0 +1,374 @@
+//
+//  SVGDisplayList.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+import SwiftGraphics
+
+/// A single resolved drawing command. Apart from beginElement every case
+/// corresponds to one call on the Renderer protocol.
+public enum SVGDisplayCommand {
+    /// The point at which SVGRenderer consults its prerenderElement callback.
+    case beginElement(SVGElement)
+    case startDocument(CGRect)
+    case startGroup(String?)
+    case startElement(String?)
+    case endElement
+    case pushGraphicsState
+    case restoreGraphicsState
+    case concatTransform(CGAffineTransform)
+    case concatCTM(CGAffineTransform)
+    /// Index into the display list's styles.
+    case setStyle(Int)
+    case setFillColor(CGColor?)
+    case setStrokeColor(CGColor?)
+    case setLineWidth(CGFloat?)
+    /// The path together with the absolute transform it is drawn with.
+    case addPath(PathGenerator, CGAffineTransform)
+    case addCGPath(CGPath, CGAffineTransform)
+    case drawPath(CGPathDrawingMode)
+    case fillPath
+    case drawText(TextRenderer, CGAffineTransform)
+    case drawLinearGradient(LinearGradientRenderer, PathGenerator, CGAffineTransform)
+    case drawRadialGradient(RadialGradientRenderer, PathGenerator, CGAffineTransform)
+}
+
+/// A flat, immutable list of the drawing commands SVGRenderer produces for a
+/// document. Fill and stroke resolution, transform concatenation and
+/// gradient inheritance have all been done, so replaying the list into any
+/// Renderer gives the same result as rendering the document without walking
+/// the element tree.
+public final class SVGDisplayList {
+    public let commands: [SVGDisplayCommand]
+    public let styles: [Style]
+
+    /// Text is recorded as outlines when there is a textOutliner, and
+    /// strokes as outlines made at strokeScale when there is a stroker.
+    public init(svgDocument: SVGDocument, textOutliner: SVGTextOutliner? = .None,
+                stroker: SVGStroker? = .None, strokeScale: CGFloat = 1.0) throws {
+        let recorder = SVGDisplayListRecorder()
+        let svgRenderer = SVGRenderer()
+        svgRenderer.textOutliner = textOutliner
+        svgRenderer.stroker = stroker
+        svgRenderer.strokeScale = strokeScale
+        svgRenderer.callbacks.prerenderElement = {
+            (svgElement: SVGElement, renderer: Renderer) -> Bool in
+            recorder.commands.append(.beginElement(svgElement))
+            return true
+        }
+        try svgRenderer.renderDocument(svgDocument, renderer: recorder)
+        self.commands = recorder.commands
+        self.styles = recorder.styles
+    }
+
+    internal init(commands: [SVGDisplayCommand], styles: [Style]) {
+        self.commands = commands
+        self.styles = styles
+    }
+
+    /// Replays the list into renderer. If prerenderElement returns false for an
+    /// element the element's commands are skipped, matching SVGRenderer.
+    public func replay(renderer: Renderer,
+               prerenderElement: ((svgElement: SVGElement, renderer: Renderer) throws -> Bool)? = nil) throws {
+        try replay(renderer, shouldRenderElement: {
+            (index: Int, svgElement: SVGElement) throws -> Bool in
+            guard let prerenderElement = prerenderElement else {
+                return true
+            }
+            return try prerenderElement(svgElement: svgElement, renderer: renderer)
+        })
+    }
+
+    /// Replays the list drawing each path from the level of levelOfDetail
+    /// suited to the scale it is drawn at. deviceTransform is the transform
+    /// from the document to device pixels, like the CTM of a context.
+    public func replay(renderer: Renderer, levelOfDetail: SVGLevelOfDetail, deviceTransform: CGAffineTransform,
+               prerenderElement: ((svgElement: SVGElement, renderer: Renderer) throws -> Bool)? = nil) throws {
+        try replay(renderer, levelOfDetail: levelOfDetail, deviceTransform: deviceTransform, shouldRenderElement: {
+            (index: Int, svgElement: SVGElement) throws -> Bool in
+            guard let prerenderElement = prerenderElement else {
+                return true
+            }
+            return try prerenderElement(svgElement: svgElement, renderer: renderer)
+        })
+    }
+
+    /// Replays the list, asking shouldRenderElement about each element by
+    /// the position of its beginElement command among all beginElement
+    /// commands.
+    internal func replay(renderer: Renderer, levelOfDetail: SVGLevelOfDetail? = .None,
+                         deviceTransform: CGAffineTransform = CGAffineTransformIdentity,
+                         shouldRenderElement: (index: Int, svgElement: SVGElement) throws -> Bool) throws {
+        try SVGInstrumentation.time(.render) {
+            try self.replayCommands(renderer, levelOfDetail: levelOfDetail, deviceTransform: deviceTransform,
+                                    shouldRenderElement: shouldRenderElement)
+        }
+    }
+
+    private func replayCommands(renderer: Renderer, levelOfDetail: SVGLevelOfDetail?, deviceTransform: CGAffineTransform,
+                                shouldRenderElement: (index: Int, svgElement: SVGElement) throws -> Bool) throws {
+        var depth = 0
+        var skipDepth: Int? = .None
+        var elementIndex = 0
+        // Set when a path too small to draw was left out, so the command
+        // drawing it is left out too.
+        var skipsDraw = false
+        // Set when a path was replaced by a dot, which is filled whatever
+        // the path's drawing mode so a stroke doesn't make it bigger.
+        var drawsDot = false
+        var strokeColor: CGColor? = .None
+
+        for command in commands {
+            if let skipToDepth = skipDepth {
+                switch command {
+                    case .beginElement:
+                        elementIndex += 1
+                    case .pushGraphicsState:
+                        depth += 1
+                    case .restoreGraphicsState:
+                        if depth == skipToDepth {
+                            skipDepth = .None
+                            renderer.restoreGraphicsState()
+                        }
+                        depth -= 1
+                    default:
+                        break
+                }
+                continue
+            }
+
+            switch command {
+                case .beginElement(let svgElement):
+                    if try shouldRenderElement(index: elementIndex, svgElement: svgElement) == false {
+                        skipDepth = depth
+                    }
+                    elementIndex += 1
+                case .startDocument(let viewBox):
+                    renderer.startDocument(viewBox)
+                case .startGroup(let id):
+                    renderer.startGroup(id)
+                case .startElement(let id):
+                    renderer.startElement(id)
+                case .endElement:
+                    renderer.endElement()
+                case .pushGraphicsState:
+                    depth += 1
+                    renderer.pushGraphicsState()
+                case .restoreGraphicsState:
+                    depth -= 1
+                    renderer.restoreGraphicsState()
+                case .concatTransform(let transform):
+                    renderer.concatTransform(transform)
+                case .concatCTM(let transform):
+                    renderer.concatCTM(transform)
+                case .setStyle(let index):
+                    renderer.style = styles[index]
+                    strokeColor = styles[index].strokeColor
+                case .setFillColor(let color):
+                    renderer.fillColor = color
+                case .setStrokeColor(let color):
+                    renderer.strokeColor = color
+                    strokeColor = color
+                case .setLineWidth(let lineWidth):
+                    renderer.lineWidth = lineWidth
+                case .addPath(let pathGenerator, let transform):
+                    if let levelOfDetail = levelOfDetail {
+                        let pathTransform = CGAffineTransformConcat(transform, deviceTransform)
+                        if let levelPath = levelOfDetail.pathGenerator(pathGenerator, transform: pathTransform) {
+                            renderer.addPath(levelPath.path)
+                            drawsDot = levelPath.isDot
+                        }
+                        else {
+                            skipsDraw = true
+                        }
+                    }
+                    else {
+                        renderer.addPath(pathGenerator)
+                    }
+                case .addCGPath(let path, _):
+                    renderer.addCGPath(path)
+                case .drawPath(let mode):
+                    if skipsDraw {
+                        skipsDraw = false
+                    }
+                    else if drawsDot {
+                        drawsDot = false
+                        drawDot(renderer, mode: mode, strokeColor: strokeColor)
+                    }
+                    else {
+                        renderer.drawPath(mode)
+                    }
+                case .fillPath:
+                    drawsDot = false
+                    if skipsDraw {
+                        skipsDraw = false
+                    }
+                    else {
+                        renderer.fillPath()
+                    }
+                case .drawText(let textRenderer, _):
+                    renderer.drawText(textRenderer)
+                case .drawLinearGradient(let linearGradient, let pathGenerator, _):
+                    renderer.drawLinearGradient(linearGradient, pathGenerator: pathGenerator)
+                case .drawRadialGradient(let radialGradient, let pathGenerator, _):
+                    renderer.drawRadialGradient(radialGradient, pathGenerator: pathGenerator)
+            }
+        }
+    }
+
+    /// Fills the dot added in place of a path drawn with mode. A path that
+    /// is only stroked gives the dot its stroke color.
+    private func drawDot(renderer: Renderer, mode: CGPathDrawingMode, strokeColor: CGColor?) {
+        guard mode == .Stroke else {
+            renderer.drawPath(.Fill)
+            return
+        }
+        renderer.pushGraphicsState()
+        renderer.fillColor = strokeColor
+        renderer.drawPath(.Fill)
+        renderer.restoreGraphicsState()
+    }
+}
+
+// MARK: -
+
+public extension SVGDocument {
+    /// The compiled display list for the document. It is only recompiled
+    /// after the document or one of its elements has changed.
+    func displayList() throws -> SVGDisplayList {
+        if let cache = displayListCache where cache.generation == generation {
+            return cache.displayList
+        }
+        let displayList = try SVGDisplayList(svgDocument: self)
+        displayListCache = (generation: generation, displayList: displayList)
+        return displayList
+    }
+}
+
+// MARK: -
+
+/// Records the calls SVGRenderer makes and tracks the absolute transform.
+private final class SVGDisplayListRecorder: Renderer {
+    var commands = [SVGDisplayCommand]()
+    var styles = [Style]()
+
+    private var transform = CGAffineTransformIdentity
+    private var transformStack = [CGAffineTransform]()
+
+    func concatTransform(transform: CGAffineTransform) {
+        self.transform = CGAffineTransformConcat(transform, self.transform)
+        commands.append(.concatTransform(transform))
+    }
+
+    func concatCTM(transform: CGAffineTransform) {
+        self.transform = CGAffineTransformConcat(transform, self.transform)
+        commands.append(.concatCTM(transform))
+    }
+
+    func pushGraphicsState() {
+        transformStack.append(transform)
+        commands.append(.pushGraphicsState)
+    }
+
+    func restoreGraphicsState() {
+        transform = transformStack.removeLast()
+        commands.append(.restoreGraphicsState)
+    }
+
+    func startDocument(viewBox: CGRect) {
+        commands.append(.startDocument(viewBox))
+    }
+
+    func startGroup(id: String?) {
+        commands.append(.startGroup(id))
+    }
+
+    func endElement() {
+        commands.append(.endElement)
+    }
+
+    func startElement(id: String?) {
+        commands.append(.startElement(id))
+    }
+
+    func addPath(path: PathGenerator) {
+        commands.append(.addPath(path, transform))
+    }
+
+    func addCGPath(path: CGPath) {
+        commands.append(.addCGPath(path, transform))
+    }
+
+    func drawPath(mode: CGPathDrawingMode) {
+        commands.append(.drawPath(mode))
+    }
+
+    func drawText(textRenderer: TextRenderer) {
+        commands.append(.drawText(textRenderer, transform))
+    }
+
+    func drawLinearGradient(linearGradient: LinearGradientRenderer, pathGenerator: PathGenerator) {
+        commands.append(.drawLinearGradient(linearGradient, pathGenerator, transform))
+    }
+
+    func drawRadialGradient(radialGradient: RadialGradientRenderer, pathGenerator: PathGenerator) {
+        commands.append(.drawRadialGradient(radialGradient, pathGenerator, transform))
+    }
+
+    func fillPath() {
+        commands.append(.fillPath)
+    }
+
+    func render() -> String {
+        return ""
+    }
+
+    var strokeColor: CGColor? {
+        get { return style.strokeColor }
+        set {
+            currentStyle.strokeColor = newValue
+            commands.append(.setStrokeColor(newValue))
+        }
+    }
+
+    var fillColor: CGColor? {
+        get { return style.fillColor }
+        set {
+            currentStyle.fillColor = newValue
+            commands.append(.setFillColor(newValue))
+        }
+    }
+
+    var lineWidth: CGFloat? {
+        get { return style.lineWidth }
+        set {
+            currentStyle.lineWidth = newValue
+            commands.append(.setLineWidth(newValue))
+        }
+    }
+
+    private var currentStyle = Style()
+    private var styleIndices = [SVGStyleKey: Int]()
+
+    var style: Style {
+        get { return currentStyle }
+        set {
+            currentStyle = newValue
+            // Equal styles share a handle.
+            let key = SVGStyleKey(style: newValue)
+            if let index = styleIndices[key] {
+                commands.append(.setStyle(index))
+            }
+            else {
+                styleIndices[key] = styles.count
+                styles.append(newValue)
+                commands.append(.setStyle(styles.count - 1))
+            }
+        }
+    }
+}
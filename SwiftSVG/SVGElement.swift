@@ -64,55 +64,195 @@ public protocol GroupNode: Node {
 // MARK: -
 
 public class SVGElement: Node {
-    static var numElements = 0
     public typealias ParentType = SVGContainer
     public weak var parent: SVGContainer? = nil
-    public internal(set) var style: SwiftGraphics.Style? = nil
-    public internal(set) var transform: Transform2D? = nil
-    public let uuid = NSUUID() // TODO: This is silly.
-    public internal(set) var id: String? = nil
-    public internal(set) var xmlElement: NSXMLElement? = nil
-    public internal(set) var textStyle: TextStyle? = nil
-    public internal(set) var gradientFill: SVGLinearGradient? = nil
-    public internal(set) var display = true
+    public internal(set) var style: SwiftGraphics.Style? = nil {
+        didSet { elementDidChange() }
+    }
+    public internal(set) var transform: Transform2D? = nil {
+        didSet { elementDidChange() }
+    }
+    public internal(set) var id: String? = nil {
+        didSet { elementDidChange() }
+    }
+    /// Attributes the processor didn't handle, copied out of the source so
+    /// that the XML element isn't kept alive. Nil for almost every element.
+    public internal(set) var unhandledAttributes: [String: String]? = nil
+    public internal(set) var textStyle: TextStyle? = nil {
+        didSet { elementDidChange() }
+    }
+    public internal(set) var gradientFill: SVGGradient? = nil {
+        didSet { elementDidChange() }
+    }
+    public internal(set) var display = true {
+        didSet { elementDidChange() }
+    }
+
+    /// Incremented every time the element or one of its descendants changes.
+    public private(set) var generation = 0
 
     init() {
-        // print("init: Number of elements = \(SVGElement.numElements)")
-        SVGElement.numElements += 1
     }
-    
-    deinit {
-        SVGElement.numElements -= 1
-        if SVGElement.numElements <= 10 {
-            // print(self.description)
-            print("deinit: Number of elements = \(SVGElement.numElements)")
+
+    var drawFill = true { // If fill="none" this explictly turns off fill.
+        didSet { elementDidChange() }
+    }
+
+    internal var localBoundsCache: CGRect?
+    internal var boundsCache: CGRect?
+    internal var linearGradientFillCache: SVGLinearGradientFill?
+    internal var radialGradientFillCache: SVGRadialGradientFill?
+
+    /// The element's linear gradient fill with inheritance resolved and bound
+    /// to this element. Cached until the element changes.
+    public var linearGradientFill: SVGLinearGradientFill? {
+        guard let gradientFill = gradientFill as? SVGLinearGradient else {
+            return .None
+        }
+        if let linearGradientFill = linearGradientFillCache {
+            return linearGradientFill
         }
+        let linearGradientFill = SVGLinearGradientFill(
+            gradient: gradientFill.coalesceLinearGradientInheritance(), owningElement: self)
+        linearGradientFillCache = linearGradientFill
+        return linearGradientFill
     }
 
-    var drawFill = true // If fill="none" this explictly turns off fill.
-    var fillColor: CGColor? {
-        get {
-            if !drawFill {
-                return nil
-            }
-            if let color = self.style?.fillColor {
-                return color
-            }
-            guard let parent = self.parent else {
-                return nil
-            }
-            
-            if parent is SVGGroup {
-                return parent.fillColor
-            }
-            
-            if parent is SVGDocument {
-                return try! SVGColors.stringToColor("black")
+    /// The element's radial gradient fill with inheritance resolved and bound
+    /// to this element. Cached until the element changes.
+    public var radialGradientFill: SVGRadialGradientFill? {
+        guard let gradientFill = gradientFill as? SVGRadialGradient else {
+            return .None
+        }
+        if let radialGradientFill = radialGradientFillCache {
+            return radialGradientFill
+        }
+        let radialGradientFill = SVGRadialGradientFill(
+            gradient: gradientFill.coalesceRadialGradientInheritance(), owningElement: self)
+        radialGradientFillCache = radialGradientFill
+        return radialGradientFill
+    }
+
+    /// Must be called whenever something that affects how this element renders
+    /// changes. Marks the owning document as changed so that anything derived
+    /// from it, like the compiled display list, gets rebuilt.
+    internal func elementDidChange() {
+        var visited = Set<ObjectIdentifier>()
+        elementDidChange(&visited)
+    }
+
+    /// Each element is changed at most once, so a use element that instances
+    /// one of its own ancestors doesn't change itself forever. Once an
+    /// element has been visited so have all of its ancestors.
+    private func elementDidChange(inout visited: Set<ObjectIdentifier>) {
+        var element: SVGElement? = self
+        while let current = element where !visited.contains(ObjectIdentifier(current)) {
+            visited.insert(ObjectIdentifier(current))
+            current.localBoundsCache = .None
+            current.boundsCache = .None
+            current.linearGradientFillCache = .None
+            current.radialGradientFillCache = .None
+            current.generation += 1
+            // Instances of this element, or of an element containing it, change too.
+            if let instances = current.instances {
+                for case let use as SVGUse in instances.allObjects {
+                    use.elementDidChange(&visited)
+                }
             }
+            element = current.parent
+        }
+    }
+
+    /// The use elements that instance this element. Weak, and only created
+    /// for elements that are referenced.
+    internal var instances: NSHashTable?
+
+    var fillColor: CGColor? {
+        get { return fillColorInContext(.None) }
+    }
+
+    /// The fill color when rendered as part of the use element instances in
+    /// context. The element a use element references inherits from the use
+    /// element rather than from its own ancestors, wherever it is in the
+    /// document. Each step to a use element moves to the outer context, so
+    /// the walk ends even when uses nest.
+    internal func fillColorInContext(context: SVGInstanceContext?) -> CGColor? {
+        if !drawFill {
             return nil
         }
+        if let color = self.style?.fillColor {
+            return color
+        }
+        if let context = context where context.use.referencedElement === self {
+            return context.use.fillColorInContext(context.outer)
+        }
+        guard let parent = self.parent else {
+            return context?.use.fillColorInContext(context?.outer)
+        }
+        
+        if parent is SVGGroup {
+            return parent.fillColorInContext(context)
+        }
+
+        if let context = context {
+            return context.use.fillColorInContext(context.outer)
+        }
+        
+        if parent is SVGDocument {
+            return try! SVGColors.stringToColor("black")
+        }
+        return nil
     }
     
+    /// The gradient fill when rendered as part of the use element instances
+    /// in context, inherited the same way as the fill color. The nearest
+    /// element that sets a fill wins, whether it is a color or a gradient.
+    internal func gradientFillInContext(context: SVGInstanceContext?) -> SVGGradient? {
+        if !drawFill || self.style?.fillColor != nil {
+            return nil
+        }
+        if let gradientFill = self.gradientFill {
+            return gradientFill
+        }
+        if let context = context where context.use.referencedElement === self {
+            return context.use.gradientFillInContext(context.outer)
+        }
+        guard let parent = self.parent else {
+            return context?.use.gradientFillInContext(context?.outer)
+        }
+        if parent is SVGGroup {
+            return parent.gradientFillInContext(context)
+        }
+        if let context = context {
+            return context.use.gradientFillInContext(context.outer)
+        }
+        return nil
+    }
+
+    /// The linear gradient fill in context, bound to this element. Only the
+    /// element's own gradient fill is cached.
+    internal func linearGradientFillInContext(context: SVGInstanceContext?) -> SVGLinearGradientFill? {
+        if gradientFill != nil {
+            return linearGradientFill
+        }
+        guard let gradient = gradientFillInContext(context) as? SVGLinearGradient else {
+            return .None
+        }
+        return SVGLinearGradientFill(gradient: gradient.coalesceLinearGradientInheritance(), owningElement: self)
+    }
+
+    /// The radial gradient fill in context, bound to this element. Only the
+    /// element's own gradient fill is cached.
+    internal func radialGradientFillInContext(context: SVGInstanceContext?) -> SVGRadialGradientFill? {
+        if gradientFill != nil {
+            return radialGradientFill
+        }
+        guard let gradient = gradientFillInContext(context) as? SVGRadialGradient else {
+            return .None
+        }
+        return SVGRadialGradientFill(gradient: gradient.coalesceRadialGradientInheritance(), owningElement: self)
+    }
+
     var hasFill: Bool {
         get { return self.fillColor != nil }
     }
@@ -120,19 +260,24 @@ public class SVGElement: Node {
     // Different default behaviour for fill and stroke. Default fill is to draw
     // black, while default stroke is not drawing anything.
     var strokeColor: CGColor? {
-        get {
-            if let color = self.style?.strokeColor {
-                return color
-            }
-            guard let parent = self.parent else {
-                return nil
-            }
-            
-            if parent is SVGGroup {
-                return parent.strokeColor
-            }
-            return nil
+        get { return strokeColorInContext(.None) }
+    }
+
+    internal func strokeColorInContext(context: SVGInstanceContext?) -> CGColor? {
+        if let color = self.style?.strokeColor {
+            return color
         }
+        if let context = context where context.use.referencedElement === self {
+            return context.use.strokeColorInContext(context.outer)
+        }
+        guard let parent = self.parent else {
+            return context?.use.strokeColorInContext(context?.outer)
+        }
+        
+        if parent is SVGGroup {
+            return parent.strokeColorInContext(context)
+        }
+        return context?.use.strokeColorInContext(context?.outer)
     }
 
     var fontFamily: String {
@@ -223,7 +368,7 @@ public func == (lhs: SVGElement, rhs: SVGElement) -> Bool {
 
 extension SVGElement: Hashable {
     public var hashValue: Int {
-        return uuid.hash
+        return ObjectIdentifier(self).hashValue
     }
 }
 
@@ -233,6 +378,7 @@ public class SVGContainer: SVGElement, GroupNode {
     public var children: [SVGElement] = [] {
         didSet {
             children.forEach() { $0.parent = self }
+            elementDidChange()
         }
     }
 
@@ -256,6 +402,7 @@ public class SVGContainer: SVGElement, GroupNode {
         oldElement.parent = nil
         children[index] = newElement
         newElement.parent = self
+        elementDidChange()
     }
     
     override public func printElements() {
@@ -286,28 +433,67 @@ public class SVGDocument: SVGContainer {
     public var viewPort: CGRect?
     public var title: String?
     public var documentDescription: String?
+
+    /// The path data of the document's path elements, set when the document
+    /// is processed.
+    public internal(set) var geometryStore: SVGGeometryStore?
+
+    /// True once an incremental processor has moved elements of this document
+    /// into a newer one. The document is emptied then and shouldn't be used.
+    public internal(set) var isInvalidated = false
+
+    internal var displayListCache: (generation: Int, displayList: SVGDisplayList)?
     
     override public func printElements() {
         super.printElements()
     }
-    
-    deinit {
-        print("SVGDocument has been deinited")
-        print("Num elements = \(SVGElement.numElements)")
-    }
 }
 
 // MARK: -
 
 public class SVGGroup: SVGContainer {
-    static var numGroups = 0
-    override init() {
-        SVGGroup.numGroups += 1
+}
+
+// MARK: -
+
+/// An instance of another element, drawn with the use element's own
+/// transform and style. The referenced element is not re-parented: it is
+/// shared by every use of it, and so is everything cached on it, like its
+/// bounds, paths and gradient fills.
+public class SVGUse: SVGElement {
+    public let referencedElement: SVGElement
+
+    public init(referencedElement: SVGElement) {
+        self.referencedElement = referencedElement
+        super.init()
+        if referencedElement.instances == nil {
+            referencedElement.instances = NSHashTable.weakObjectsHashTable()
+        }
+        referencedElement.instances!.addObject(self)
     }
-    
-    deinit {
-        SVGGroup.numGroups -= 1
-        // print("Group deinit. Number of groups: \(SVGGroup.numGroups)")
+}
+
+/// The chain of use elements an element is being rendered through,
+/// innermost first.
+internal final class SVGInstanceContext {
+    let use: SVGUse
+    let outer: SVGInstanceContext?
+
+    init(use: SVGUse, outer: SVGInstanceContext?) {
+        self.use = use
+        self.outer = outer
+    }
+
+    /// Whether use is in the chain, which means it instances itself.
+    func contains(use: SVGUse) -> Bool {
+        var context: SVGInstanceContext? = self
+        while let current = context {
+            if current.use === use {
+                return true
+            }
+            context = current.outer
+        }
+        return false
     }
 }
 
@@ -334,24 +520,58 @@ public protocol LinearGradientRenderer {
     var linearGradient: CGGradient? { get }
     var startPoint: CGPoint? { get }
     var endPoint: CGPoint? { get }
+    var spreadMethod: SVGSpreadMethod { get }
+    var ramp: SVGGradientRamp? { get }
+}
+
+/// The focal point, center and radius are in gradient space, which
+/// gradientTransform maps to user space.
+public protocol RadialGradientRenderer {
+    var miRadialGradient: MovingImagesGradient? { get }
+    var radialGradient: CGGradient? { get }
+    var focalPoint: CGPoint { get }
+    var centerPoint: CGPoint { get }
+    var radius: CGFloat { get }
+    var gradientTransform: CGAffineTransform { get }
+    var spreadMethod: SVGSpreadMethod { get }
+    var ramp: SVGGradientRamp? { get }
 }
 
 // MARK: -
 
 public class SVGPath: SVGElement, PathGenerator {
-    public private(set) var cgpath: CGPath
-    public private(set) var svgpath: String?
+    /// The path data, and the geometry built from it when first asked for.
+    public private(set) var source: SVGPathSource
+
+    public var cgpath: CGPath {
+        return source.cgpath
+    }
+
+    public var svgpath: String? {
+        return source.svgpath
+    }
+
     public var mipath: MovingImagesPath? { get { return .None } }
-    public var evenOdd: Bool = false
+    public var evenOdd: Bool = false {
+        didSet { elementDidChange() }
+    }
 
     public init(path: CGPath, svgPath: String) {
-        self.cgpath = path
-        self.svgpath = svgPath
+        self.source = SVGPathSource(path: path, svgPath: svgPath)
+    }
+
+    public init(source: SVGPathSource) {
+        self.source = source
     }
 
     internal func addSVGPath(svgPath: SVGPath) {
-        self.cgpath = self.cgpath + svgPath.cgpath
-        self.svgpath = .None
+        self.source = SVGPathSource(path: self.cgpath + svgPath.cgpath)
+        elementDidChange()
+    }
+
+    internal func replaceGeometry(geometry: SVGPathGeometry) {
+        self.source = SVGPathSource(path: geometry.makeCGPath(), svgPath: geometry.svgPath)
+        elementDidChange()
     }
 }
 
@@ -385,7 +605,7 @@ public class SVGLine: SVGElement, PathGenerator {
 }
 
 public class SVGPolygon: SVGElement, PathGenerator {
-    public let polygon:SwiftGraphics.Polygon
+    public private(set) var polygon:SwiftGraphics.Polygon
     
     lazy public var cgpath:CGPath = self.polygon.cgpath
     lazy public var mipath:MovingImagesPath? = makePolygonDictionary(self.polygon.points)
@@ -401,10 +621,17 @@ public class SVGPolygon: SVGElement, PathGenerator {
     public init(points: [CGPoint]) {
         self.polygon = SwiftGraphics.Polygon(points: points)
     }
+
+    internal func replacePoints(points: [CGPoint]) {
+        self.polygon = SwiftGraphics.Polygon(points: points)
+        self.cgpath = self.polygon.cgpath
+        self.mipath = makePolygonDictionary(points)
+        elementDidChange()
+    }
 }
 
 public class SVGPolyline: SVGElement, PathGenerator {
-    public let points: [CGPoint]
+    public private(set) var points: [CGPoint]
     
     lazy public var cgpath:CGPath = self.makePath()
     lazy public var mipath:MovingImagesPath? = makePolylineDictionary(self.points)
@@ -420,6 +647,13 @@ public class SVGPolyline: SVGElement, PathGenerator {
     public init(points: [CGPoint]) {
         self.points = points
     }
+
+    internal func replacePoints(points: [CGPoint]) {
+        self.points = points
+        self.cgpath = self.makePath()
+        self.mipath = makePolylineDictionary(points)
+        elementDidChange()
+    }
     
     private func makePath() -> CGPath {
         let localPath = CGPathCreateMutable()
@@ -555,7 +789,7 @@ public final class SVGTextSpan: TextRenderer {
     
     public lazy var textOrigin: CGPoint = self.calculateOrigin()
     
-    private let localOrigin: CGPoint
+    internal let localOrigin: CGPoint
     
     init(string: String, textOrigin: CGPoint) {
         self.string = string
@@ -644,40 +878,7 @@ public final class SVGTextSpan: TextRenderer {
     }
     
     private func getPostscriptFontName() -> NSString {
-        let fontFamily = self.fontFamily
-        var attributes: [NSString : AnyObject]
-        if fontFamily.containsString(",") {
-            let fonts = fontFamily.componentsSeparatedByCharactersInSet(NSCharacterSet(charactersInString: ","))
-            let familyName = fonts[0]
-            let cascadeFonts = fonts.dropFirst(1)
-            let cascadeDescriptors: [CTFontDescriptor] = cascadeFonts.map() {
-                let cascadeAttributes: [NSString : NSObject] = [
-                    kCTFontSizeAttribute : self.fontSize,
-                    kCTFontFamilyNameAttribute : $0
-                ]
-                return CTFontDescriptorCreateWithAttributes(cascadeAttributes)
-            }
-            attributes = [
-                kCTFontSizeAttribute : self.fontSize,
-                kCTFontFamilyNameAttribute : familyName,
-                kCTFontCascadeListAttribute : cascadeDescriptors
-            ]
-        }
-        else {
-            attributes = [
-                kCTFontFamilyNameAttribute : self.fontFamily,
-                kCTFontSizeAttribute : self.fontSize,
-            ]
-        }
-
-        let descriptor = CTFontDescriptorCreateWithAttributes(attributes)
-        if let tempFontName = CTFontDescriptorCopyAttribute(descriptor, kCTFontNameAttribute) {
-            return tempFontName as! NSString
-        }
-    
-        let theFont = CTFontCreateWithFontDescriptorAndOptions(descriptor, self.fontSize, nil, CTFontOptions.Default)
-        let postScriptName = CTFontCopyPostScriptName(theFont)
-        return postScriptName
+        return SVGFontCache.sharedCache.font(family: self.fontFamily, size: self.fontSize).postscriptName
     }
     
     private func calculateOrigin() -> CGPoint {
@@ -689,22 +890,22 @@ public final class SVGTextSpan: TextRenderer {
             return localOrigin
         }
         
-        let line = CTLineCreateWithAttributedString(self.cttext)
-        let boundingRect = CTLineGetBoundsWithOptions(line, CTLineBoundsOptions(rawValue: 0))
+        // Colors and strokes don't change the typographic width.
+        let width = SVGFontCache.sharedCache.stringWidth(self.string as String, family: self.fontFamily, size: self.fontSize)
         
         var theOrigin = self.localOrigin
         if textAnchor == TextAnchor.middle {
-            theOrigin.x -= boundingRect.width / 2
+            theOrigin.x -= width / 2
         }
         else if textAnchor == TextAnchor.end {
-            theOrigin.x -= boundingRect.width
+            theOrigin.x -= width
         }
         return theOrigin
     }
     
     private final func makeAttributedString() -> CFAttributedString {
         var attributes: [NSString : AnyObject] = [
-            kCTFontAttributeName : CTFontCreateWithName(self.getPostscriptFontName(), self.fontSize, nil),
+            kCTFontAttributeName : SVGFontCache.sharedCache.font(family: self.fontFamily, size: self.fontSize).ctFont,
         ]
         
         if let fillColor = self.fillColor {
@@ -749,36 +950,40 @@ public enum SVGGradientUnit : String {
     case objectBoundingBox
 }
 
-public class SVGLinearGradient: SVGElement, LinearGradientRenderer {
-    public lazy var linearGradient: CGGradient? = self.makeLinearGradient()
-    public lazy var miLinearGradient: MovingImagesGradient? = self.makeMILinearGradient()
-    public lazy var startPoint: CGPoint? = self.makeStartPoint()
-    public lazy var endPoint: CGPoint? = self.makeEndPoint()
-    
-    // Just before rendering of the owningElement it assigns itself to the gradient.
-    weak var owningElement: SVGElement?
-    
-    let point1: CGPoint?
-    let point2: CGPoint?
+
+/// The attributes shared by linear and radial gradients. A gradient can
+/// inherit from any other gradient through xlink:href, which the processor
+/// stores as the gradient's gradientFill.
+public class SVGGradient: SVGElement {
+    public lazy var ramp: SVGGradientRamp? = self.makeRamp()
+    public lazy var cgGradient: CGGradient? = self.makeCGGradient()
+
+    private var resolvedGradient: SVGGradient?
+
     let stops: [SVGGradientStop]?
     let gradientUnit: SVGGradientUnit
-    
-    public init(stops: [SVGGradientStop]?,
-         gradientUnit: SVGGradientUnit,
-               point1: CGPoint? = .None,
-               point2: CGPoint? = .None,
-            transform: Transform2D?,
-            inherited: SVGLinearGradient?) {
+    let optionalSpreadMethod: SVGSpreadMethod?
+
+    public var spreadMethod: SVGSpreadMethod {
+        return optionalSpreadMethod ?? .pad
+    }
+
+    init(stops: [SVGGradientStop]?,
+  gradientUnit: SVGGradientUnit,
+  spreadMethod: SVGSpreadMethod?,
+     transform: Transform2D?,
+     inherited: SVGGradient?) {
         self.stops = stops
-        self.point1 = point1
-        self.point2 = point2
         self.gradientUnit = gradientUnit
+        self.optionalSpreadMethod = spreadMethod
         super.init()
         self.gradientFill = inherited
         self.transform = transform
     }
-    
-    final private func convertPoint(point: CGPoint) -> CGPoint? {
+
+    /// Converts a gradient point to user space. Points in objectBoundingBox
+    /// units need the bounds of the element being filled.
+    final internal func convertPoint(point: CGPoint, boundingBox: CGRect?) -> CGPoint? {
         var thePoint = point
         if gradientUnit == SVGGradientUnit.userSpaceOnUse {
             if let theTransform = transform {
@@ -789,8 +994,7 @@ public class SVGLinearGradient: SVGElement, LinearGradientRenderer {
             if thePoint.x < 0.0 || thePoint.x > 1.0 { return .None }
             if thePoint.y < 0.0 || thePoint.y > 1.0 { return .None }
             
-            if let owner = owningElement as? PathGenerator {
-                let boundingBox = CGPathGetPathBoundingBox(owner.cgpath)
+            if let boundingBox = boundingBox {
                 thePoint.x = boundingBox.origin.x + thePoint.x * boundingBox.size.width
                 thePoint.y = boundingBox.origin.y + thePoint.y * boundingBox.size.height
                 if let theTransform = transform {
@@ -804,65 +1008,57 @@ public class SVGLinearGradient: SVGElement, LinearGradientRenderer {
         return thePoint
     }
 
-    private func makeMILinearGradient() -> MovingImagesGradient? {
-        guard let _ = self.startPoint else {
-            return .None
-        }
-
-        guard let _ = self.endPoint else {
+    final private func makeCGGradient() -> CGGradient? {
+        if !canRender() {
             return .None
         }
-
+        
         var colors = [CGColor]()
         var locations = [CGFloat]()
         stops?.forEach() {
             colors.append($0.color)
             locations.append($0.offset)
         }
-
-        return makeMILinearGradientDictionary(colors: colors,
-                                           locations: locations,
-                                          startPoint: self.startPoint!,
-                                            endPoint: self.endPoint!)
+        return CGGradientCreateWithColors(CGColorGetColorSpace(colors[0]), colors, locations)
     }
 
-    final private func makeStartPoint() -> CGPoint? {
-        let thePoint = point1 ?? CGPoint(x: 0.0, y: 0.0)
-        return convertPoint(thePoint)
-    }
-    
-    final private func makeEndPoint() -> CGPoint? {
-        let thePoint = point2 ?? CGPoint(x: 1.0, y: 1.0)
-        return convertPoint(thePoint)
-    }
-    
-    final private func makeLinearGradient() -> CGGradient? {
-        if !canRender() {
+    final private func makeRamp() -> SVGGradientRamp? {
+        guard let stops = stops else {
             return .None
         }
-        
-        var colors = [CGColor]()
-        var locations = [CGFloat]()
-        stops?.forEach() {
-            colors.append($0.color)
-            locations.append($0.offset)
-        }
-        return CGGradientCreateWithColors(CGColorGetColorSpace(colors[0]), colors, locations)
+        return SVGGradientRamp(stops: stops, spreadMethod: spreadMethod)
     }
-    
-    // Since linear gradient fills can inherit from earlier defined linear gradient fills
-    // we need to keep drilling down and combining the results.
-    func coalesceLinearGradientInheritance() -> SVGLinearGradient {
-        guard let inheritedGradient = self.gradientFill else {
-            return self
+
+    // Since gradient fills can inherit from earlier defined gradient fills
+    // we need to keep drilling down and combining the results. The result is
+    // cached, the processor resolves each referenced gradient while parsing.
+    final func coalesceGradientInheritance() -> SVGGradient {
+        if let resolvedGradient = resolvedGradient {
+            return resolvedGradient
         }
-        
-        let superInherited = inheritedGradient.coalesceLinearGradientInheritance()
-        
-        let pt1 = self.point1 ?? superInherited.point1
-        let pt2 = self.point2 ?? superInherited.point2
+        let resolved: SVGGradient
+        if let inheritedGradient = self.gradientFill {
+            resolved = makeCoalescedGradient(inheritedGradient.coalesceGradientInheritance())
+        }
+        else {
+            resolved = self
+        }
+        resolvedGradient = resolved
+        return resolved
+    }
+
+    /// Subclasses return a new gradient combining themselves with the
+    /// already resolved gradient they inherit from.
+    internal func makeCoalescedGradient(superInherited: SVGGradient) -> SVGGradient {
+        return self
+    }
+
+    /// The attributes common to all gradients combined with those inherited.
+    internal func coalescedAttributes(superInherited: SVGGradient) -> (stops: [SVGGradientStop]?,
+            gradientUnit: SVGGradientUnit, spreadMethod: SVGSpreadMethod?, transform: Transform2D?, style: Style) {
         let stops = self.stops ?? superInherited.stops
         let gradientUnit = self.gradientUnit == SVGGradientUnit.userSpaceOnUse ? self.gradientUnit : superInherited.gradientUnit
+        let spreadMethod = self.optionalSpreadMethod ?? superInherited.optionalSpreadMethod
         
         let style: Style
         if var inheritedStyle = superInherited.style {
@@ -887,24 +1083,10 @@ public class SVGLinearGradient: SVGElement, LinearGradientRenderer {
                 transform = .None
             }
         }
-        let linearGradient = SVGLinearGradient(stops: stops, gradientUnit: gradientUnit,
-                                               point1: pt1, point2: pt2,
-                                               transform: transform, inherited: .None)
-        linearGradient.style = style
-        linearGradient.id = self.id
-        return linearGradient
+        return (stops, gradientUnit, spreadMethod, transform, style)
     }
     
     func canRender() -> Bool {
-/*
-        guard let _ = self.point1 else {
-            return false
-        }
-
-        guard let _ = self.point2 else {
-            return false
-        }
-*/
         guard let _ = self.stops else {
             return false
         }
@@ -912,3 +1094,320 @@ public class SVGLinearGradient: SVGElement, LinearGradientRenderer {
         return true
     }
 }
+
+// MARK: -
+
+public class SVGLinearGradient: SVGGradient, LinearGradientRenderer {
+    public lazy var miLinearGradient: MovingImagesGradient? = self.makeMILinearGradient()
+    public lazy var startPoint: CGPoint? = self.makeStartPoint()
+    public lazy var endPoint: CGPoint? = self.makeEndPoint()
+
+    public var linearGradient: CGGradient? {
+        return cgGradient
+    }
+
+    let point1: CGPoint?
+    let point2: CGPoint?
+    
+    public init(stops: [SVGGradientStop]?,
+         gradientUnit: SVGGradientUnit,
+         spreadMethod: SVGSpreadMethod? = .None,
+               point1: CGPoint? = .None,
+               point2: CGPoint? = .None,
+            transform: Transform2D?,
+            inherited: SVGGradient?) {
+        self.point1 = point1
+        self.point2 = point2
+        super.init(stops: stops, gradientUnit: gradientUnit, spreadMethod: spreadMethod,
+                   transform: transform, inherited: inherited)
+    }
+
+    private func makeMILinearGradient() -> MovingImagesGradient? {
+        guard let _ = self.startPoint else {
+            return .None
+        }
+
+        guard let _ = self.endPoint else {
+            return .None
+        }
+
+        var colors = [CGColor]()
+        var locations = [CGFloat]()
+        stops?.forEach() {
+            colors.append($0.color)
+            locations.append($0.offset)
+        }
+
+        return makeMILinearGradientDictionary(colors: colors,
+                                           locations: locations,
+                                          startPoint: self.startPoint!,
+                                            endPoint: self.endPoint!)
+    }
+
+    final private func makeStartPoint() -> CGPoint? {
+        let thePoint = point1 ?? CGPoint(x: 0.0, y: 0.0)
+        return convertPoint(thePoint, boundingBox: .None)
+    }
+    
+    final private func makeEndPoint() -> CGPoint? {
+        let thePoint = point2 ?? CGPoint(x: 1.0, y: 1.0)
+        return convertPoint(thePoint, boundingBox: .None)
+    }
+    
+    func coalesceLinearGradientInheritance() -> SVGLinearGradient {
+        return coalesceGradientInheritance() as! SVGLinearGradient
+    }
+
+    override internal func makeCoalescedGradient(superInherited: SVGGradient) -> SVGGradient {
+        let attributes = coalescedAttributes(superInherited)
+        // The end points can only be inherited from another linear gradient.
+        let inheritedLinear = superInherited as? SVGLinearGradient
+        let pt1 = self.point1 ?? inheritedLinear?.point1
+        let pt2 = self.point2 ?? inheritedLinear?.point2
+        let linearGradient = SVGLinearGradient(stops: attributes.stops, gradientUnit: attributes.gradientUnit,
+                                               spreadMethod: attributes.spreadMethod,
+                                               point1: pt1, point2: pt2,
+                                               transform: attributes.transform, inherited: .None)
+        linearGradient.style = attributes.style
+        linearGradient.id = self.id
+        return linearGradient
+    }
+}
+
+// MARK: -
+
+public class SVGRadialGradient: SVGGradient {
+    // Each coordinate is kept as specified, or .None, so it can be inherited
+    // on its own. The defaults are applied once inheritance is resolved.
+    let centerX: CGFloat?
+    let centerY: CGFloat?
+    let radius: CGFloat?
+    let focalX: CGFloat?
+    let focalY: CGFloat?
+    /// The viewport of the document the gradient is in, which percentages
+    /// are of in userSpaceOnUse units.
+    let viewport: CGRect?
+
+    /// cx and cy, which default to 50% of the bounding box, or of the
+    /// viewport in userSpaceOnUse units.
+    var center: CGPoint {
+        let size = percentageSize
+        return CGPoint(x: centerX ?? 0.5 * size.width, y: centerY ?? 0.5 * size.height)
+    }
+
+    /// r, which defaults to 50% of the diagonal of the bounding box or the
+    /// viewport, divided by the square root of two as the specification
+    /// normalizes it.
+    var resolvedRadius: CGFloat {
+        let size = percentageSize
+        return radius ?? 0.5 * sqrt(0.5 * (size.width * size.width + size.height * size.height))
+    }
+
+    private var percentageSize: CGSize {
+        if gradientUnit == .userSpaceOnUse, let viewport = viewport {
+            return viewport.size
+        }
+        return CGSize(width: 1.0, height: 1.0)
+    }
+
+    /// fx and fy, which default to the center.
+    var focalPoint: CGPoint {
+        let center = self.center
+        return CGPoint(x: focalX ?? center.x, y: focalY ?? center.y)
+    }
+
+    public init(stops: [SVGGradientStop]?,
+         gradientUnit: SVGGradientUnit,
+         spreadMethod: SVGSpreadMethod? = .None,
+              centerX: CGFloat? = .None,
+              centerY: CGFloat? = .None,
+               radius: CGFloat? = .None,
+               focalX: CGFloat? = .None,
+               focalY: CGFloat? = .None,
+             viewport: CGRect? = .None,
+            transform: Transform2D?,
+            inherited: SVGGradient?) {
+        self.centerX = centerX
+        self.centerY = centerY
+        self.radius = radius
+        self.focalX = focalX
+        self.focalY = focalY
+        self.viewport = viewport
+        super.init(stops: stops, gradientUnit: gradientUnit, spreadMethod: spreadMethod,
+                   transform: transform, inherited: inherited)
+    }
+
+    func coalesceRadialGradientInheritance() -> SVGRadialGradient {
+        return coalesceGradientInheritance() as! SVGRadialGradient
+    }
+
+    override internal func makeCoalescedGradient(superInherited: SVGGradient) -> SVGGradient {
+        let attributes = coalescedAttributes(superInherited)
+        // The circles can only be inherited from another radial gradient.
+        let inheritedRadial = superInherited as? SVGRadialGradient
+        let radialGradient = SVGRadialGradient(stops: attributes.stops, gradientUnit: attributes.gradientUnit,
+                                               spreadMethod: attributes.spreadMethod,
+                                               centerX: self.centerX ?? inheritedRadial?.centerX,
+                                               centerY: self.centerY ?? inheritedRadial?.centerY,
+                                               radius: self.radius ?? inheritedRadial?.radius,
+                                               focalX: self.focalX ?? inheritedRadial?.focalX,
+                                               focalY: self.focalY ?? inheritedRadial?.focalY,
+                                               viewport: self.viewport ?? inheritedRadial?.viewport,
+                                               transform: attributes.transform, inherited: .None)
+        radialGradient.style = attributes.style
+        radialGradient.id = self.id
+        return radialGradient
+    }
+}
+
+// MARK: -
+
+/// A resolved linear gradient bound to the element it fills. The end points
+/// of a gradient in objectBoundingBox units depend on the bounds of the
+/// element, so they are calculated here once per element rather than once
+/// per render.
+public final class SVGLinearGradientFill: LinearGradientRenderer {
+    public let gradient: SVGLinearGradient
+    private weak var owningElement: SVGElement?
+
+    public lazy var startPoint: CGPoint? = self.makePoint(self.gradient.point1 ?? CGPoint(x: 0.0, y: 0.0))
+    public lazy var endPoint: CGPoint? = self.makePoint(self.gradient.point2 ?? CGPoint(x: 1.0, y: 1.0))
+    public lazy var miLinearGradient: MovingImagesGradient? = self.makeMILinearGradient()
+
+    public var linearGradient: CGGradient? {
+        return gradient.linearGradient
+    }
+
+    public var spreadMethod: SVGSpreadMethod {
+        return gradient.spreadMethod
+    }
+
+    public var ramp: SVGGradientRamp? {
+        return gradient.ramp
+    }
+
+    init(gradient: SVGLinearGradient, owningElement: SVGElement) {
+        self.gradient = gradient
+        self.owningElement = owningElement
+    }
+
+    private func makePoint(point: CGPoint) -> CGPoint? {
+        let boundingBox: CGRect?
+        if let owner = owningElement where owner is PathGenerator {
+            boundingBox = owner.localBounds
+        }
+        else {
+            boundingBox = .None
+        }
+        return gradient.convertPoint(point, boundingBox: boundingBox)
+    }
+
+    private func makeMILinearGradient() -> MovingImagesGradient? {
+        guard let startPoint = self.startPoint, let endPoint = self.endPoint else {
+            return .None
+        }
+
+        var colors = [CGColor]()
+        var locations = [CGFloat]()
+        gradient.stops?.forEach() {
+            colors.append($0.color)
+            locations.append($0.offset)
+        }
+
+        return makeMILinearGradientDictionary(colors: colors,
+                                           locations: locations,
+                                          startPoint: startPoint,
+                                            endPoint: endPoint)
+    }
+}
+
+// MARK: -
+
+/// A resolved radial gradient bound to the element it fills. The circles are
+/// kept in gradient space, with objectBoundingBox units mapped to the
+/// element's bounds by gradientTransform, because a circle in bounding box
+/// units is an ellipse in user space.
+public final class SVGRadialGradientFill: RadialGradientRenderer {
+    public let gradient: SVGRadialGradient
+    private weak var owningElement: SVGElement?
+
+    public let centerPoint: CGPoint
+    public let radius: CGFloat
+    public let focalPoint: CGPoint
+
+    public lazy var gradientTransform: CGAffineTransform = self.makeGradientTransform()
+    public lazy var miRadialGradient: MovingImagesGradient? = self.makeMIRadialGradient()
+
+    public var radialGradient: CGGradient? {
+        return gradient.cgGradient
+    }
+
+    public var spreadMethod: SVGSpreadMethod {
+        return gradient.spreadMethod
+    }
+
+    public var ramp: SVGGradientRamp? {
+        return gradient.ramp
+    }
+
+    init(gradient: SVGRadialGradient, owningElement: SVGElement) {
+        self.gradient = gradient
+        self.owningElement = owningElement
+        let center = gradient.center
+        let radius = gradient.resolvedRadius
+        self.centerPoint = center
+        self.radius = radius
+
+        // A focal point outside the circle is moved onto it, as the
+        // specification requires, just inside so the gradient stays a cone.
+        var focalPoint = gradient.focalPoint
+        let dx = focalPoint.x - center.x
+        let dy = focalPoint.y - center.y
+        let distance = sqrt(dx * dx + dy * dy)
+        let maximumDistance = 0.99 * radius
+        if distance > maximumDistance {
+            let scale = maximumDistance / distance
+            focalPoint = CGPoint(x: center.x + dx * scale, y: center.y + dy * scale)
+        }
+        self.focalPoint = focalPoint
+    }
+
+    private func makeGradientTransform() -> CGAffineTransform {
+        var transform = CGAffineTransformIdentity
+        if gradient.gradientUnit == .objectBoundingBox {
+            if let owner = owningElement where owner is PathGenerator {
+                let boundingBox = owner.localBounds
+                transform = CGAffineTransformMake(boundingBox.width, 0.0, 0.0, boundingBox.height,
+                                                  boundingBox.minX, boundingBox.minY)
+            }
+        }
+        // gradientTransform applies in bounding box units, before they are
+        // mapped to the element's bounds.
+        if let theTransform = gradient.transform {
+            transform = CGAffineTransformConcat(theTransform.toCGAffineTransform(), transform)
+        }
+        return transform
+    }
+
+    private func makeMIRadialGradient() -> MovingImagesGradient? {
+        var colors = [CGColor]()
+        var locations = [CGFloat]()
+        gradient.stops?.forEach() {
+            colors.append($0.color)
+            locations.append($0.offset)
+        }
+        if colors.isEmpty {
+            return .None
+        }
+
+        // MovingImages draws circles, so a non uniform scale is approximated
+        // by its average scale.
+        let transform = gradientTransform
+        let scale = sqrt(abs(transform.a * transform.d - transform.b * transform.c))
+        return makeMIRadialGradientDictionary(colors: colors,
+                                           locations: locations,
+                                          focalPoint: CGPointApplyAffineTransform(focalPoint, transform),
+                                         centerPoint: CGPointApplyAffineTransform(centerPoint, transform),
+                                              radius: radius * scale)
+    }
+}
@@ -0,0 +1,165 @@
+//
+//  SVGFontCache.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+/// Fonts resolved from font-family lists, and the widths of strings set in
+/// them, shared by every text span in the process. Documents with many
+/// labels use a handful of families and sizes, and resolving a family list
+/// through CoreText descriptors costs far more than looking it up.
+///
+/// The cache is thread safe. Fonts are resolved outside the lock, so two
+/// threads can resolve the same font at once and the second one is kept.
+public final class SVGFontCache {
+    public struct Font {
+        public let postscriptName: NSString
+        public let ctFont: CTFont
+    }
+
+    public static let sharedCache = SVGFontCache()
+
+    /// Widths are forgotten once there are this many.
+    public var maximumWidthCount = 10000
+
+    public init() {
+    }
+
+    /// The font for a font-family list, the first family that is installed
+    /// being used. Families after the first are the font's cascade list.
+    public func font(family family: String, size: CGFloat) -> Font {
+        let key = FontKey(family: family, size: size)
+        lock.lock()
+        let cachedFont = fonts[key]
+        lock.unlock()
+        if let font = cachedFont {
+            return font
+        }
+
+        let postscriptName = SVGFontCache.postscriptName(family: family, size: size)
+        let font = Font(postscriptName: postscriptName, ctFont: CTFontCreateWithName(postscriptName, size, nil))
+        lock.lock()
+        fonts[key] = font
+        lock.unlock()
+        return font
+    }
+
+    /// The typographic width of string set in the font for family and size.
+    public func stringWidth(string: String, family: String, size: CGFloat) -> CGFloat {
+        let key = WidthKey(string: string, font: FontKey(family: family, size: size))
+        lock.lock()
+        let cachedWidth = widths[key]
+        lock.unlock()
+        if let width = cachedWidth {
+            return width
+        }
+
+        let attributes: [NSString : AnyObject] = [
+            kCTFontAttributeName : font(family: family, size: size).ctFont
+        ]
+        let attributedString = CFAttributedStringCreate(kCFAllocatorDefault, string, attributes)
+        let line = CTLineCreateWithAttributedString(attributedString)
+        let width = CTLineGetBoundsWithOptions(line, CTLineBoundsOptions(rawValue: 0)).width
+        lock.lock()
+        if widths.count >= maximumWidthCount {
+            widths.removeAll(keepCapacity: true)
+        }
+        widths[key] = width
+        lock.unlock()
+        return width
+    }
+
+    public var fontCount: Int {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        return fonts.count
+    }
+
+    public var widthCount: Int {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        return widths.count
+    }
+
+    public func removeAll() {
+        lock.lock()
+        fonts.removeAll()
+        widths.removeAll()
+        lock.unlock()
+    }
+
+    // MARK: -
+
+    private let lock = NSLock()
+    private var fonts = [FontKey: Font]()
+    private var widths = [WidthKey: CGFloat]()
+
+    private static func postscriptName(family family: String, size: CGFloat) -> NSString {
+        var attributes: [NSString : AnyObject]
+        if family.containsString(",") {
+            let fonts = family.componentsSeparatedByCharactersInSet(NSCharacterSet(charactersInString: ","))
+            let familyName = fonts[0]
+            let cascadeFonts = fonts.dropFirst(1)
+            let cascadeDescriptors: [CTFontDescriptor] = cascadeFonts.map() {
+                let cascadeAttributes: [NSString : NSObject] = [
+                    kCTFontSizeAttribute : size,
+                    kCTFontFamilyNameAttribute : $0
+                ]
+                return CTFontDescriptorCreateWithAttributes(cascadeAttributes)
+            }
+            attributes = [
+                kCTFontSizeAttribute : size,
+                kCTFontFamilyNameAttribute : familyName,
+                kCTFontCascadeListAttribute : cascadeDescriptors
+            ]
+        }
+        else {
+            attributes = [
+                kCTFontFamilyNameAttribute : family,
+                kCTFontSizeAttribute : size,
+            ]
+        }
+
+        let descriptor = CTFontDescriptorCreateWithAttributes(attributes)
+        if let tempFontName = CTFontDescriptorCopyAttribute(descriptor, kCTFontNameAttribute) {
+            return tempFontName as! NSString
+        }
+
+        let theFont = CTFontCreateWithFontDescriptorAndOptions(descriptor, size, nil, CTFontOptions.Default)
+        return CTFontCopyPostScriptName(theFont)
+    }
+}
+
+private struct FontKey: Hashable {
+    let family: String
+    let size: CGFloat
+
+    var hashValue: Int {
+        return family.hashValue ^ size.hashValue
+    }
+}
+
+private func == (lhs: FontKey, rhs: FontKey) -> Bool {
+    return lhs.size == rhs.size && lhs.family == rhs.family
+}
+
+private struct WidthKey: Hashable {
+    let string: String
+    let font: FontKey
+
+    var hashValue: Int {
+        return string.hashValue ^ font.hashValue
+    }
+}
+
+private func == (lhs: WidthKey, rhs: WidthKey) -> Bool {
+    return lhs.font == rhs.font && lhs.string == rhs.string
+}
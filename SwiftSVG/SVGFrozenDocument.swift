@@ -0,0 +1,292 @@
+//
+//  SVGFrozenDocument.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+import SwiftGraphics
+
+/// An immutable, fully resolved snapshot of a document that any number of
+/// threads can render at the same time without locking.
+///
+/// The snapshot is the document's display list with every path, text span
+/// and gradient replaced by a copy whose properties were all computed when
+/// the document was frozen. Rendering it never touches the lazy properties
+/// of the document's elements. The elements are only kept to be passed to
+/// callbacks, which shouldn't read their lazily created properties if they
+/// can be called on more than one thread.
+///
+/// Changing the document afterwards doesn't change the snapshot.
+public final class SVGFrozenDocument {
+    public let viewBox: CGRect?
+    public let displayList: SVGDisplayList
+
+    /// The bounds in document space of each element, including its stroke,
+    /// in the order the elements begin in the display list. Elements that
+    /// draw nothing have null bounds and text has infinite bounds.
+    public let elementBounds: [CGRect]
+
+    /// The generation of each element when the snapshot was taken, in the
+    /// same order as elementBounds.
+    public let elementGenerations: [Int]
+
+    public convenience init(svgDocument: SVGDocument) throws {
+        try self.init(svgDocument: svgDocument, displayList: svgDocument.displayList())
+    }
+
+    /// A snapshot of a display list recorded from svgDocument, for example
+    /// with text or strokes outlined.
+    public init(svgDocument: SVGDocument, displayList: SVGDisplayList) {
+        viewBox = svgDocument.viewBox
+        var freezer = SVGFreezer()
+        self.displayList = freezer.freeze(displayList)
+        elementBounds = freezer.elementBounds
+        elementGenerations = freezer.elementGenerations
+    }
+
+    /// Renders the snapshot. The commands of an element for which
+    /// shouldRenderElement returns false are skipped. The element index is
+    /// the index into elementBounds.
+    public func render(renderer: Renderer, shouldRenderElement: ((index: Int) -> Bool)? = nil) throws {
+        try displayList.replay(renderer, shouldRenderElement: {
+            (index: Int, svgElement: SVGElement) -> Bool in
+            return shouldRenderElement?(index: index) ?? true
+        })
+    }
+}
+
+public extension SVGDocument {
+    /// An immutable snapshot of the document for rendering on several
+    /// threads at once.
+    func freeze() throws -> SVGFrozenDocument {
+        return try SVGInstrumentation.attribute("freeze") {
+            try SVGFrozenDocument(svgDocument: self)
+        }
+    }
+}
+
+// MARK: -
+
+private final class SVGFrozenPath: PathGenerator {
+    let cgpath: CGPath
+    let svgpath: String?
+    let mipath: MovingImagesPath?
+    private let frozenEvenOdd: Bool
+
+    var evenOdd: Bool {
+        get { return frozenEvenOdd }
+        set { }
+    }
+
+    init(pathGenerator: PathGenerator) {
+        cgpath = CGPathCreateCopy(pathGenerator.cgpath) ?? pathGenerator.cgpath
+        svgpath = pathGenerator.svgpath
+        mipath = pathGenerator.mipath
+        frozenEvenOdd = pathGenerator.evenOdd
+    }
+}
+
+private final class SVGFrozenText: TextRenderer {
+    let mitext: MovingImagesText
+    let cttext: CFAttributedString
+    let textOrigin: CGPoint
+
+    init(textRenderer: TextRenderer) {
+        mitext = textRenderer.mitext
+        cttext = CFAttributedStringCreateCopy(kCFAllocatorDefault, textRenderer.cttext)
+        textOrigin = textRenderer.textOrigin
+    }
+}
+
+private final class SVGFrozenLinearGradient: LinearGradientRenderer {
+    let miLinearGradient: MovingImagesGradient?
+    let linearGradient: CGGradient?
+    let startPoint: CGPoint?
+    let endPoint: CGPoint?
+    let spreadMethod: SVGSpreadMethod
+    let ramp: SVGGradientRamp?
+
+    init(linearGradient: LinearGradientRenderer) {
+        miLinearGradient = linearGradient.miLinearGradient
+        self.linearGradient = linearGradient.linearGradient
+        startPoint = linearGradient.startPoint
+        endPoint = linearGradient.endPoint
+        spreadMethod = linearGradient.spreadMethod
+        ramp = linearGradient.ramp
+    }
+}
+
+private final class SVGFrozenRadialGradient: RadialGradientRenderer {
+    let miRadialGradient: MovingImagesGradient?
+    let radialGradient: CGGradient?
+    let focalPoint: CGPoint
+    let centerPoint: CGPoint
+    let radius: CGFloat
+    let gradientTransform: CGAffineTransform
+    let spreadMethod: SVGSpreadMethod
+    let ramp: SVGGradientRamp?
+
+    init(radialGradient: RadialGradientRenderer) {
+        miRadialGradient = radialGradient.miRadialGradient
+        self.radialGradient = radialGradient.radialGradient
+        focalPoint = radialGradient.focalPoint
+        centerPoint = radialGradient.centerPoint
+        radius = radialGradient.radius
+        gradientTransform = radialGradient.gradientTransform
+        spreadMethod = radialGradient.spreadMethod
+        ramp = radialGradient.ramp
+    }
+}
+
+/// Copies a display list, freezing each path, text span and gradient once
+/// however many times it's drawn, and works out the bounds of each element.
+private struct SVGFreezer {
+    var elementBounds = [CGRect]()
+    var elementGenerations = [Int]()
+
+    private var paths = [ObjectIdentifier: SVGFrozenPath]()
+    private var texts = [ObjectIdentifier: SVGFrozenText]()
+    private var linearGradients = [ObjectIdentifier: SVGFrozenLinearGradient]()
+    private var radialGradients = [ObjectIdentifier: SVGFrozenRadialGradient]()
+
+    // The elements that have begun and not yet ended, with the depth of the
+    // graphics state they end at.
+    private var openElements = [(index: Int, depth: Int)]()
+    private var depth = 0
+    // The renderer starts documents with a line width of 1.
+    private var lineWidth: CGFloat = 1.0
+    private var miterLimit: CGFloat = 10.0
+    private var strokeStack = [(lineWidth: CGFloat, miterLimit: CGFloat)]()
+
+    mutating func freeze(displayList: SVGDisplayList) -> SVGDisplayList {
+        var commands = [SVGDisplayCommand]()
+        commands.reserveCapacity(displayList.commands.count)
+        for command in displayList.commands {
+            switch command {
+                case .beginElement(let svgElement):
+                    openElements.append((index: elementBounds.count, depth: depth))
+                    elementBounds.append(CGRect.null)
+                    elementGenerations.append(svgElement.generation)
+                    commands.append(command)
+                case .pushGraphicsState:
+                    depth += 1
+                    strokeStack.append((lineWidth: lineWidth, miterLimit: miterLimit))
+                    commands.append(command)
+                case .restoreGraphicsState:
+                    if let element = openElements.last where element.depth == depth {
+                        openElements.removeLast()
+                        // A container covers everything its children draw.
+                        addBounds(elementBounds[element.index])
+                    }
+                    depth -= 1
+                    if let stroke = strokeStack.popLast() {
+                        (lineWidth, miterLimit) = stroke
+                    }
+                    commands.append(command)
+                case .setStyle(let index):
+                    lineWidth = displayList.styles[index].lineWidth ?? lineWidth
+                    miterLimit = displayList.styles[index].miterLimit ?? miterLimit
+                    commands.append(command)
+                case .setLineWidth(let newLineWidth):
+                    lineWidth = newLineWidth ?? lineWidth
+                    commands.append(command)
+                case .addPath(let pathGenerator, let transform):
+                    let path = frozenPath(pathGenerator)
+                    addBounds(strokedBounds(path.cgpath), transform: transform)
+                    commands.append(.addPath(path, transform))
+                case .addCGPath(let path, let transform):
+                    addBounds(strokedBounds(path), transform: transform)
+                    commands.append(.addCGPath(CGPathCreateCopy(path) ?? path, transform))
+                case .drawText(let textRenderer, let transform):
+                    addBounds(CGRect.infinite)
+                    commands.append(.drawText(frozenText(textRenderer), transform))
+                case .drawLinearGradient(let linearGradient, let pathGenerator, let transform):
+                    let path = frozenPath(pathGenerator)
+                    addBounds(CGPathGetPathBoundingBox(path.cgpath), transform: transform)
+                    commands.append(.drawLinearGradient(frozenLinearGradient(linearGradient), path, transform))
+                case .drawRadialGradient(let radialGradient, let pathGenerator, let transform):
+                    let path = frozenPath(pathGenerator)
+                    addBounds(CGPathGetPathBoundingBox(path.cgpath), transform: transform)
+                    commands.append(.drawRadialGradient(frozenRadialGradient(radialGradient), path, transform))
+                default:
+                    commands.append(command)
+            }
+        }
+        return SVGDisplayList(commands: commands, styles: displayList.styles)
+    }
+
+    private func strokedBounds(path: CGPath) -> CGRect {
+        // Conservative: miter joins can extend to half the miter limit times the line width.
+        let outset = 0.5 * lineWidth * max(miterLimit, 1.5)
+        return CGRectInset(CGPathGetPathBoundingBox(path), -outset, -outset)
+    }
+
+    private mutating func addBounds(bounds: CGRect, transform: CGAffineTransform) {
+        addBounds(bounds.isNull ? bounds : CGRectApplyAffineTransform(bounds, transform))
+    }
+
+    private mutating func addBounds(bounds: CGRect) {
+        guard let element = openElements.last where !bounds.isNull else {
+            return
+        }
+        let elementBoundsSoFar = elementBounds[element.index]
+        if bounds.isInfinite || elementBoundsSoFar.isInfinite {
+            elementBounds[element.index] = CGRect.infinite
+        }
+        else {
+            elementBounds[element.index] = elementBoundsSoFar.union(bounds)
+        }
+    }
+
+    private mutating func frozenPath(pathGenerator: PathGenerator) -> SVGFrozenPath {
+        guard let object = pathGenerator as? AnyObject else {
+            return SVGFrozenPath(pathGenerator: pathGenerator)
+        }
+        if let path = paths[ObjectIdentifier(object)] {
+            return path
+        }
+        let path = SVGFrozenPath(pathGenerator: pathGenerator)
+        paths[ObjectIdentifier(object)] = path
+        return path
+    }
+
+    private mutating func frozenText(textRenderer: TextRenderer) -> SVGFrozenText {
+        guard let object = textRenderer as? AnyObject else {
+            return SVGFrozenText(textRenderer: textRenderer)
+        }
+        if let text = texts[ObjectIdentifier(object)] {
+            return text
+        }
+        let text = SVGFrozenText(textRenderer: textRenderer)
+        texts[ObjectIdentifier(object)] = text
+        return text
+    }
+
+    private mutating func frozenLinearGradient(linearGradient: LinearGradientRenderer) -> SVGFrozenLinearGradient {
+        guard let object = linearGradient as? AnyObject else {
+            return SVGFrozenLinearGradient(linearGradient: linearGradient)
+        }
+        if let gradient = linearGradients[ObjectIdentifier(object)] {
+            return gradient
+        }
+        let gradient = SVGFrozenLinearGradient(linearGradient: linearGradient)
+        linearGradients[ObjectIdentifier(object)] = gradient
+        return gradient
+    }
+
+    private mutating func frozenRadialGradient(radialGradient: RadialGradientRenderer) -> SVGFrozenRadialGradient {
+        guard let object = radialGradient as? AnyObject else {
+            return SVGFrozenRadialGradient(radialGradient: radialGradient)
+        }
+        if let gradient = radialGradients[ObjectIdentifier(object)] {
+            return gradient
+        }
+        let gradient = SVGFrozenRadialGradient(radialGradient: radialGradient)
+        radialGradients[ObjectIdentifier(object)] = gradient
+        return gradient
+    }
+}
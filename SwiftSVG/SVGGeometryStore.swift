@@ -0,0 +1,212 @@
+//
+//  SVGGeometryStore.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+/// The path data of a document's path elements, so path data repeated in
+/// the source, like a pasted icon or a map symbol, is parsed at most once and
+/// every element with it shares one CGPath and one string.
+///
+/// Path data is compared with the whitespace and commas it doesn't need to
+/// keep its tokens apart removed, so the same path written with different
+/// spacing is shared, and looked up by an FNV-1a hash of that. The store
+/// isn't thread safe.
+public final class SVGGeometryStore {
+    public let arcTolerance: CGFloat
+
+    /// The number of lookups that found the path data already in the store.
+    public private(set) var hitCount = 0
+
+    /// The number of distinct path data strings.
+    public private(set) var count = 0
+
+    public init(arcTolerance: CGFloat = MI_SVGDefaultArcTolerance) {
+        self.arcTolerance = arcTolerance
+    }
+
+    /// The shared source for svgPath. Path data is only parsed when a path
+    /// element with it is first drawn or measured.
+    public func source(svgPath: String) -> SVGPathSource {
+        var hash = FNV1aHash()
+        let normalized = SVGGeometryStore.normalize(svgPath, hash: &hash)
+        if let bucket = sources[hash.value] {
+            for entry in bucket where entry.normalized == normalized {
+                hitCount += 1
+                SVGInstrumentation.count("geometry.shared")
+                return entry.source
+            }
+        }
+        let source = SVGPathSource(svgPath: svgPath, arcTolerance: arcTolerance)
+        sources[hash.value] = (sources[hash.value] ?? []) + [(normalized: normalized, source: source)]
+        count += 1
+        return source
+    }
+
+    public func removeAll() {
+        sources.removeAll()
+        hitCount = 0
+        count = 0
+    }
+
+    // MARK: -
+
+    private var sources = [UInt64: [(normalized: [UInt8], source: SVGPathSource)]]()
+
+    /// The UTF-8 of svgPath with the whitespace and commas between tokens
+    /// removed wherever the tokens stay apart without them: next to a command
+    /// letter, before a sign, and before a decimal point when the number
+    /// before it already has one. Those left are replaced by a space.
+    private static func normalize(svgPath: String, inout hash: FNV1aHash) -> [UInt8] {
+        var normalized = [UInt8]()
+        normalized.reserveCapacity(svgPath.utf8.count)
+        var separated = false
+        // Whether the last token is a number, and whether it has a decimal
+        // point or an exponent, after which a decimal point starts a number.
+        var afterNumber = false
+        var afterFraction = false
+        for byte in svgPath.utf8 {
+            switch byte {
+                case 0x20, 0x09, 0x0A, 0x0D, 0x2C:
+                    separated = true
+                    continue
+                case 0x30...0x39:
+                    if separated && afterNumber {
+                        normalized.append(0x20)
+                    }
+                    if separated || !afterNumber {
+                        afterFraction = false
+                    }
+                    afterNumber = true
+                case 0x2E:
+                    if separated && afterNumber && !afterFraction {
+                        normalized.append(0x20)
+                    }
+                    afterNumber = true
+                    afterFraction = true
+                case 0x2B, 0x2D:
+                    // A sign straight after an exponent belongs to it.
+                    if separated || !(normalized.last == 0x65 || normalized.last == 0x45) {
+                        afterFraction = false
+                    }
+                    afterNumber = true
+                case 0x65, 0x45:
+                    afterFraction = true
+                default:
+                    afterNumber = false
+                    afterFraction = false
+            }
+            separated = false
+            normalized.append(byte)
+        }
+        for byte in normalized {
+            hash.addByte(byte)
+        }
+        return normalized
+    }
+}
+
+/// The geometry of path elements, kept as the path data from the source and
+/// built into a CGPath, compact geometry, or a polyline the first time
+/// something asks for one. Exporting to MovingImages only needs the path
+/// data, so never builds any of them, and only simplifying curves builds the
+/// polyline. Shared by the path elements with the same path data, and thread
+/// safe.
+///
+/// When instrumentation is enabled each form built is counted as
+/// "materialized.cgpath", "materialized.geometry" or "materialized.polyline"
+/// followed by a dot and the consumer set with SVGInstrumentation.attribute,
+/// and the segments of a CGPath are counted when it is built.
+public final class SVGPathSource {
+    /// Nil for geometry made by joining or simplifying paths, which is built
+    /// as a CGPath.
+    public let svgpath: String?
+
+    public var cgpath: CGPath {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        return makeCGPath()
+    }
+
+    public var geometry: SVGPathGeometry {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        if let geometry = builtGeometry {
+            return geometry
+        }
+        let geometry = SVGPathGeometry(path: makeCGPath())
+        // Calculated now so the lazy bounds aren't set from several threads.
+        _ = geometry.bounds
+        SVGInstrumentation.count("materialized.geometry." + SVGInstrumentation.consumer)
+        builtGeometry = geometry
+        return geometry
+    }
+
+    /// The geometry with its curves flattened into lines, within the arc
+    /// tolerance the path data's arcs are built with.
+    public var polyline: SVGPathGeometry {
+        let geometry = self.geometry
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        if let polyline = builtPolyline {
+            return polyline
+        }
+        let polyline = geometry.flattened(arcTolerance)
+        _ = polyline.bounds
+        SVGInstrumentation.count("materialized.polyline." + SVGInstrumentation.consumer)
+        builtPolyline = polyline
+        return polyline
+    }
+
+    /// Whether the CGPath has been built.
+    public var isMaterialized: Bool {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        return builtPath != nil
+    }
+
+    public init(svgPath: String, arcTolerance: CGFloat = MI_SVGDefaultArcTolerance) {
+        self.svgpath = svgPath
+        self.arcTolerance = arcTolerance
+    }
+
+    public init(path: CGPath, svgPath: String? = .None) {
+        self.svgpath = svgPath
+        self.arcTolerance = MI_SVGDefaultArcTolerance
+        self.builtPath = path
+    }
+
+    // MARK: -
+
+    private let arcTolerance: CGFloat
+    private let lock = NSLock()
+    private var builtPath: CGPath?
+    private var builtGeometry: SVGPathGeometry?
+    private var builtPolyline: SVGPathGeometry?
+
+    // Called with the lock held.
+    private func makeCGPath() -> CGPath {
+        if let path = builtPath {
+            return path
+        }
+        let path = SVGInstrumentation.time(.paths) {
+            MICGPathCreateFromSVGPath(self.svgpath ?? "", tolerance: self.arcTolerance)
+        }
+        SVGInstrumentation.count("materialized.cgpath." + SVGInstrumentation.consumer)
+        SVGProcessor.countPathSegments(path)
+        builtPath = path
+        return path
+    }
+}
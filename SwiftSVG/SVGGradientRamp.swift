@@ -0,0 +1,174 @@
+//
+//  SVGGradientRamp.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+import simd
+
+/// How a gradient fills the area beyond its start and end.
+public enum SVGSpreadMethod: String {
+    case pad
+    case reflect
+    case `repeat`
+}
+
+/// A gradient's stops sampled into a lookup table of premultiplied sRGB
+/// pixels, so filling a pixel is a table lookup rather than an
+/// interpolation between stops. Spans of pixels are filled four at a time.
+public final class SVGGradientRamp {
+    public static let defaultSize = 256
+
+    public let size: Int
+    public let spreadMethod: SVGSpreadMethod
+
+    /// One premultiplied pixel per entry with the bytes in RGBA order. This is
+    /// the layout of a bitmap context with premultiplied last alpha.
+    public let pixels: [UInt32]
+
+    public init?(stops: [SVGGradientStop], spreadMethod: SVGSpreadMethod, size: Int = SVGGradientRamp.defaultSize) {
+        if stops.isEmpty || size < 2 {
+            return nil
+        }
+
+        // Colors are interpolated unpremultiplied, as the specification
+        // requires, and premultiplied once per entry. Offsets are clamped so
+        // that each is no smaller than the one before.
+        var offsets = [Float]()
+        var colors = [float4]()
+        var lastOffset: Float = 0.0
+        for stop in stops {
+            guard let color = rgbaComponents(stop.color) else {
+                return nil
+            }
+            lastOffset = max(lastOffset, min(max(Float(stop.offset), 0.0), 1.0))
+            offsets.append(lastOffset)
+            colors.append(color)
+        }
+
+        var pixels = [UInt32](count: size, repeatedValue: 0)
+        var stopIndex = 0
+        for index in 0..<size {
+            let t = Float(index) / Float(size - 1)
+            while stopIndex < offsets.count && offsets[stopIndex] < t {
+                stopIndex += 1
+            }
+            let color: float4
+            if stopIndex == 0 {
+                color = colors[0]
+            }
+            else if stopIndex == offsets.count {
+                color = colors[colors.count - 1]
+            }
+            else {
+                let offset0 = offsets[stopIndex - 1]
+                let offset1 = offsets[stopIndex]
+                let fraction = offset1 > offset0 ? (t - offset0) / (offset1 - offset0) : 1.0
+                color = colors[stopIndex - 1] + fraction * (colors[stopIndex] - colors[stopIndex - 1])
+            }
+            pixels[index] = premultipliedPixel(color)
+        }
+        self.size = size
+        self.spreadMethod = spreadMethod
+        self.pixels = pixels
+    }
+
+    /// Maps positions along the gradient into 0...1 according to the spread method.
+    @inline(__always) private func spread(t: float4) -> float4 {
+        switch spreadMethod {
+            case .pad:
+                return min(max(t, float4(0.0)), float4(1.0))
+            case .`repeat`:
+                return fract(t)
+            case .reflect:
+                return float4(1.0) - abs(2.0 * fract(0.5 * t) - float4(1.0))
+        }
+    }
+
+    @inline(__always) private func lookup(t: float4, span: UnsafeMutablePointer<UInt32>, count: Int) {
+        let index = spread(t) * Float(size - 1) + float4(0.5)
+        span[0] = pixels[Int(index.x)]
+        if count > 1 { span[1] = pixels[Int(index.y)] }
+        if count > 2 { span[2] = pixels[Int(index.z)] }
+        if count > 3 { span[3] = pixels[Int(index.w)] }
+    }
+
+    /// Fills count pixels of a linear gradient. t0 is the position along the
+    /// gradient of the first pixel and dt how much it changes per pixel.
+    public func fillLinearSpan(span: UnsafeMutablePointer<UInt32>, count: Int, t0: Float, dt: Float) {
+        let steps = dt * float4(0.0, 1.0, 2.0, 3.0)
+        var index = 0
+        while index < count {
+            let t = float4(t0 + Float(index) * dt) + steps
+            lookup(t, span: span.advancedBy(index), count: count - index)
+            index += 4
+        }
+    }
+
+    /// Fills count pixels of a radial gradient. The gradient runs from a zero
+    /// radius circle at the focal point to the circle with center and radius.
+    /// point is the first pixel and step the change per pixel, and both
+    /// point and center are relative to the focal point. The focal point must
+    /// be inside the circle.
+    public func fillRadialSpan(span: UnsafeMutablePointer<UInt32>, count: Int,
+                               point: CGPoint, step: CGVector, center: CGPoint, radius: CGFloat) {
+        // Solve |p - t * center| = t * radius for t. With the focal point inside
+        // the circle the quadratic's leading coefficient a is negative.
+        let centerX = Float(center.x)
+        let centerY = Float(center.y)
+        let a = min(centerX * centerX + centerY * centerY - Float(radius * radius), -1.0e-6)
+        let steps = float4(0.0, 1.0, 2.0, 3.0)
+        var index = 0
+        while index < count {
+            let x = float4(Float(point.x) + Float(index) * Float(step.dx)) + Float(step.dx) * steps
+            let y = float4(Float(point.y) + Float(index) * Float(step.dy)) + Float(step.dy) * steps
+            let pointDotCenter = x * centerX + y * centerY
+            let pointDotPoint = x * x + y * y
+            let discriminant = max(pointDotCenter * pointDotCenter - a * pointDotPoint, float4(0.0))
+            let root = float4(sqrtf(discriminant.x), sqrtf(discriminant.y),
+                              sqrtf(discriminant.z), sqrtf(discriminant.w))
+            let t = (pointDotCenter - root) * (1.0 / a)
+            lookup(t, span: span.advancedBy(index), count: count - index)
+            index += 4
+        }
+    }
+
+    /// Creates an image filling each row with fillRow. Row 0 is the top row.
+    public class func makeImage(width: Int, height: Int,
+                                fillRow: (row: Int, span: UnsafeMutablePointer<UInt32>) -> Void) -> CGImage? {
+        guard width > 0 && height > 0,
+            let context = SVGTiledRenderer.makeBitmapContext(width, height: height) else {
+            return .None
+        }
+        let data = UnsafeMutablePointer<UInt8>(CGBitmapContextGetData(context))
+        let bytesPerRow = CGBitmapContextGetBytesPerRow(context)
+        for row in 0..<height {
+            fillRow(row: row, span: UnsafeMutablePointer<UInt32>(data.advancedBy(row * bytesPerRow)))
+        }
+        return CGBitmapContextCreateImage(context)
+    }
+}
+
+private func rgbaComponents(color: CGColor) -> float4? {
+    let components = color.components
+    switch CGColorSpaceGetModel(CGColorGetColorSpace(color)) {
+        case .RGB where components.count == 4:
+            return float4(Float(components[0]), Float(components[1]), Float(components[2]), Float(components[3]))
+        case .Monochrome where components.count == 2:
+            return float4(Float(components[0]), Float(components[0]), Float(components[0]), Float(components[1]))
+        default:
+            return nil
+    }
+}
+
+private func premultipliedPixel(color: float4) -> UInt32 {
+    let alpha = min(max(color.w, 0.0), 1.0)
+    let premultiplied = min(max(float4(color.x * alpha, color.y * alpha, color.z * alpha, alpha),
+                                float4(0.0)), float4(1.0))
+    let bytes = 255.0 * premultiplied + float4(0.5)
+    let pixel = UInt32(bytes.x) | UInt32(bytes.y) << 8 | UInt32(bytes.z) << 16 | UInt32(bytes.w) << 24
+    return UInt32(littleEndian: pixel)
+}
@@ -0,0 +1,308 @@
+//
+//  SVGLayerCache.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+/// Draws a frozen document with its groups rasterized into cached bitmaps,
+/// so redrawing while panning composites a few images instead of rendering
+/// every element.
+///
+/// A group is drawn from a layer when it has at least minimumElementCount
+/// elements and fits in maximumLayerSize device pixels, otherwise its own
+/// groups are considered. A layer is drawn at the device scale when it is
+/// made and reused until the scale moves more than scaleThreshold times
+/// away from it, or the group changes or moves in the snapshot being drawn.
+/// Layers are evicted least recently used first once they take more than
+/// maximumByteCount bytes.
+///
+/// A group's layer includes what prerenderElement draws for the elements in
+/// it, so call removeAll when that changes. The cache isn't thread safe.
+public final class SVGLayerCache {
+    public var maximumByteCount = 256 * 1024 * 1024
+
+    public var scaleThreshold: CGFloat = 1.5
+
+    /// Device pixels.
+    public var maximumLayerSize = 4096
+
+    public var minimumElementCount = 16
+
+    public private(set) var byteCount = 0
+    public private(set) var hitCount = 0
+    public private(set) var missCount = 0
+
+    public var count: Int {
+        return layers.count
+    }
+
+    public init() {
+    }
+
+    /// Draws frozenDocument into context through its current transform,
+    /// which maps the document's coordinates to device pixels.
+    public func draw(frozenDocument: SVGFrozenDocument, context: CGContext, levelOfDetail: SVGLevelOfDetail? = .None,
+                     prerenderElement: ((svgElement: SVGElement, renderer: Renderer) throws -> Bool)? = nil) throws {
+        let deviceTransform = CGContextGetCTM(context)
+        let scale = maximumScale(deviceTransform)
+        let tree = elementTree(frozenDocument)
+        var occurrences = [ObjectIdentifier: Int]()
+
+        try frozenDocument.displayList.replay(context, levelOfDetail: levelOfDetail, deviceTransform: deviceTransform,
+                                              shouldRenderElement: {
+            (index: Int, svgElement: SVGElement) throws -> Bool in
+            if let prerenderElement = prerenderElement {
+                guard try prerenderElement(svgElement: svgElement, renderer: context) else {
+                    return false
+                }
+            }
+            guard svgElement is SVGGroup && tree.subtreeEnds[index] - index >= self.minimumElementCount else {
+                return true
+            }
+            let bounds = frozenDocument.elementBounds[index]
+            guard !bounds.isNull && !bounds.isInfinite else {
+                return true
+            }
+            let deviceBounds = CGRectApplyAffineTransform(bounds, deviceTransform)
+            guard deviceBounds.width <= CGFloat(self.maximumLayerSize) &&
+                deviceBounds.height <= CGFloat(self.maximumLayerSize) else {
+                return true
+            }
+
+            // A group instanced by several use elements has a layer for each.
+            let elementIdentifier = ObjectIdentifier(svgElement)
+            let occurrence = occurrences[elementIdentifier] ?? 0
+            occurrences[elementIdentifier] = occurrence + 1
+            let key = LayerKey(element: elementIdentifier, ancestors: tree.ancestorHashes[index], occurrence: occurrence)
+
+            // Compared with the snapshot, not the element, which may have
+            // changed since the snapshot was taken.
+            let generation = frozenDocument.elementGenerations[index]
+            let layer: Layer
+            if let cachedLayer = self.layers[key] where cachedLayer.generation == generation &&
+                cachedLayer.bounds == bounds && scale <= cachedLayer.scale * self.scaleThreshold &&
+                scale * self.scaleThreshold >= cachedLayer.scale {
+                self.hitCount += 1
+                layer = cachedLayer
+            }
+            else {
+                self.missCount += 1
+                self.removeLayer(key)
+                guard let newLayer = try self.makeLayer(frozenDocument, tree: tree, index: index, key: key,
+                                                        bounds: bounds, scale: scale, generation: generation,
+                                                        levelOfDetail: levelOfDetail,
+                                                        prerenderElement: prerenderElement) else {
+                    return true
+                }
+                layer = newLayer
+                self.layers[key] = layer
+                self.byteCount += layer.byteCount
+            }
+            self.markUsed(layer)
+            self.evictLayers()
+
+            CGContextSaveGState(context)
+            // Back to document space from the space of the group's parent,
+            // flipped as images are drawn y up.
+            CGContextConcatCTM(context, CGAffineTransformConcat(deviceTransform,
+                CGAffineTransformInvert(CGContextGetCTM(context))))
+            CGContextTranslateCTM(context, 0.0, layer.rect.minY + layer.rect.maxY)
+            CGContextScaleCTM(context, 1.0, -1.0)
+            CGContextDrawImage(context, layer.rect, layer.image)
+            CGContextRestoreGState(context)
+            return false
+        })
+    }
+
+    public func removeAll() {
+        layers.removeAll()
+        mostRecentlyUsed = .None
+        leastRecentlyUsed = .None
+        byteCount = 0
+    }
+
+    // MARK: -
+
+    private final class Layer {
+        let key: LayerKey
+        let image: CGImage
+        /// The document space rectangle the image covers.
+        let rect: CGRect
+        /// The group's bounds when it was drawn.
+        let bounds: CGRect
+        let scale: CGFloat
+        let generation: Int
+        let byteCount: Int
+        /// The neighbours in the list of layers from most to least recently
+        /// used.
+        weak var moreRecentlyUsed: Layer?
+        var lessRecentlyUsed: Layer?
+
+        init(key: LayerKey, image: CGImage, rect: CGRect, bounds: CGRect, scale: CGFloat, generation: Int) {
+            self.key = key
+            self.image = image
+            self.rect = rect
+            self.bounds = bounds
+            self.scale = scale
+            self.generation = generation
+            self.byteCount = CGImageGetBytesPerRow(image) * CGImageGetHeight(image)
+        }
+    }
+
+    /// The parent and extent of each element in a display list, by the index
+    /// of its beginElement command.
+    private struct ElementTree {
+        /// The index after the element's last descendant.
+        var subtreeEnds = [Int]()
+        var parents = [Int?]()
+        /// Combines the identities of the element's ancestors, so a group
+        /// reused under a new parent gets a new layer.
+        var ancestorHashes = [Int]()
+    }
+
+    private var layers = [LayerKey: Layer]()
+    private var mostRecentlyUsed: Layer?
+    private weak var leastRecentlyUsed: Layer?
+    private var tree: (frozenDocument: SVGFrozenDocument, tree: ElementTree)?
+
+    private func elementTree(frozenDocument: SVGFrozenDocument) -> ElementTree {
+        if let tree = tree where tree.frozenDocument === frozenDocument {
+            return tree.tree
+        }
+        var elementTree = ElementTree()
+        var openElements = [(index: Int, depth: Int, hash: Int)]()
+        var depth = 0
+        for command in frozenDocument.displayList.commands {
+            switch command {
+                case .beginElement(let svgElement):
+                    let parent = openElements.last
+                    elementTree.parents.append(parent?.index)
+                    elementTree.subtreeEnds.append(elementTree.subtreeEnds.count + 1)
+                    elementTree.ancestorHashes.append(parent?.hash ?? 0)
+                    let hash = (parent?.hash ?? 0) &* 31 &+ ObjectIdentifier(svgElement).hashValue
+                    openElements.append((index: elementTree.subtreeEnds.count - 1, depth: depth, hash: hash))
+                case .pushGraphicsState:
+                    depth += 1
+                case .restoreGraphicsState:
+                    if let element = openElements.last where element.depth == depth {
+                        openElements.removeLast()
+                        elementTree.subtreeEnds[element.index] = elementTree.subtreeEnds.count
+                    }
+                    depth -= 1
+                default:
+                    break
+            }
+        }
+        tree = (frozenDocument: frozenDocument, tree: elementTree)
+        return elementTree
+    }
+
+    /// Renders the group at index, with the state its ancestors set, into an
+    /// image covering its bounds at scale.
+    private func makeLayer(frozenDocument: SVGFrozenDocument, tree: ElementTree, index: Int, key: LayerKey,
+                           bounds: CGRect, scale: CGFloat, generation: Int, levelOfDetail: SVGLevelOfDetail?,
+                           prerenderElement: ((svgElement: SVGElement, renderer: Renderer) throws -> Bool)?) throws -> Layer? {
+        // Outset for antialiasing and aligned to whole pixels.
+        let pixelRect = CGRectIntegral(CGRect(x: bounds.minX * scale - 1.0, y: bounds.minY * scale - 1.0,
+                                              width: bounds.width * scale + 2.0, height: bounds.height * scale + 2.0))
+        let rect = CGRect(x: pixelRect.minX / scale, y: pixelRect.minY / scale,
+                          width: pixelRect.width / scale, height: pixelRect.height / scale)
+        guard let context = SVGTiledRenderer.makeBitmapContext(Int(pixelRect.width), height: Int(pixelRect.height)) else {
+            return .None
+        }
+        let layerTransform = SVGTiledRenderer.documentTransform(viewBox: rect, size: pixelRect.size)
+        CGContextConcatCTM(context, layerTransform)
+
+        var ancestors = Set<Int>()
+        var ancestor = tree.parents[index]
+        while let ancestorIndex = ancestor {
+            ancestors.insert(ancestorIndex)
+            ancestor = tree.parents[ancestorIndex]
+        }
+        let subtree = index..<tree.subtreeEnds[index]
+        try frozenDocument.displayList.replay(context, levelOfDetail: levelOfDetail, deviceTransform: layerTransform,
+                                              shouldRenderElement: {
+            (elementIndex: Int, element: SVGElement) throws -> Bool in
+            if ancestors.contains(elementIndex) {
+                return true
+            }
+            guard subtree.contains(elementIndex) else {
+                return false
+            }
+            // The group's own callback was made when it was drawn.
+            if elementIndex == index {
+                return true
+            }
+            return try prerenderElement?(svgElement: element, renderer: context) ?? true
+        })
+        guard let image = CGBitmapContextCreateImage(context) else {
+            return .None
+        }
+        return Layer(key: key, image: image, rect: rect, bounds: bounds, scale: scale, generation: generation)
+    }
+
+    private func removeLayer(key: LayerKey) {
+        if let layer = layers.removeValueForKey(key) {
+            unlink(layer)
+            byteCount -= layer.byteCount
+        }
+    }
+
+    private func unlink(layer: Layer) {
+        if let moreRecentlyUsed = layer.moreRecentlyUsed {
+            moreRecentlyUsed.lessRecentlyUsed = layer.lessRecentlyUsed
+        }
+        else if mostRecentlyUsed === layer {
+            mostRecentlyUsed = layer.lessRecentlyUsed
+        }
+        if let lessRecentlyUsed = layer.lessRecentlyUsed {
+            lessRecentlyUsed.moreRecentlyUsed = layer.moreRecentlyUsed
+        }
+        else if leastRecentlyUsed === layer {
+            leastRecentlyUsed = layer.moreRecentlyUsed
+        }
+        layer.moreRecentlyUsed = .None
+        layer.lessRecentlyUsed = .None
+    }
+
+    /// Moves layer to the front of the list.
+    private func markUsed(layer: Layer) {
+        if mostRecentlyUsed === layer {
+            return
+        }
+        unlink(layer)
+        layer.lessRecentlyUsed = mostRecentlyUsed
+        mostRecentlyUsed?.moreRecentlyUsed = layer
+        mostRecentlyUsed = layer
+        if leastRecentlyUsed == nil {
+            leastRecentlyUsed = layer
+        }
+    }
+
+    private func evictLayers() {
+        while byteCount > maximumByteCount && layers.count > 1 {
+            guard let leastRecentlyUsed = leastRecentlyUsed else {
+                return
+            }
+            removeLayer(leastRecentlyUsed.key)
+        }
+    }
+}
+
+private struct LayerKey: Hashable {
+    let element: ObjectIdentifier
+    let ancestors: Int
+    let occurrence: Int
+
+    var hashValue: Int {
+        return element.hashValue ^ ancestors ^ occurrence
+    }
+}
+
+private func == (lhs: LayerKey, rhs: LayerKey) -> Bool {
+    return lhs.element == rhs.element && lhs.ancestors == rhs.ancestors && lhs.occurrence == rhs.occurrence
+}
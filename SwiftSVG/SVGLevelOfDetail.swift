@@ -0,0 +1,187 @@
+//
+//  SVGLevelOfDetail.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+/// Simplified versions of the paths of display lists, so a document drawn
+/// zoomed out doesn't push every vertex of every outline to the renderer.
+///
+/// Each path has a level for each tolerance, built with Douglas-Peucker the
+/// first time the path is drawn small enough to use it, or for every path at
+/// once by prepare. A tolerance is in the units the path is drawn in, so is
+/// how far in device pixels the level moves the outline when the path is
+/// drawn at one device pixel per unit. A path is drawn from the coarsest
+/// level that moves its outline by no more than maximumError device pixels,
+/// and paths whose bounds are smaller than minimumSize device pixels across
+/// are drawn as a filled dot of that size or skipped. A path drawn at a scale
+/// where even the finest level would move it too far is drawn as it is,
+/// without measuring it or building its levels.
+///
+/// Levels are kept by the identity of the paths' CGPaths, and keep them
+/// alive. The levels are thread safe.
+public final class SVGLevelOfDetail {
+    public let tolerances: [CGFloat]
+
+    /// Device pixels.
+    public var maximumError: CGFloat = 0.5
+
+    /// Device pixels.
+    public var minimumSize: CGFloat = 1.0
+
+    /// Whether paths smaller than minimumSize are drawn as a dot rather than
+    /// skipped.
+    public var drawsSmallPathsAsDots = true
+
+    /// Levels are forgotten once there are this many paths.
+    public var maximumCount = 100000
+
+    public init(tolerances: [CGFloat] = [1.0, 4.0, 16.0]) {
+        self.tolerances = tolerances.sort()
+    }
+
+    /// Builds every level of every path in displayList, in parallel. Call it
+    /// on a background queue to have the levels ready before zooming out,
+    /// with a display list whose paths are safe to read on that queue, like
+    /// a frozen document's. A prepare still running when removeAll is called
+    /// stops, and keeps none of the levels it builds.
+    public func prepare(displayList: SVGDisplayList) {
+        lock.lock()
+        let generation = self.generation
+        lock.unlock()
+        var pathGenerators = [PathGenerator]()
+        for command in displayList.commands {
+            if case .addPath(let pathGenerator, _) = command {
+                pathGenerators.append(pathGenerator)
+            }
+        }
+        let queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0)
+        dispatch_apply(pathGenerators.count, queue) { index in
+            guard let pyramid = self.pyramid(pathGenerators[index].cgpath, generation: generation) else {
+                return
+            }
+            for level in 0..<self.tolerances.count {
+                pyramid.levelPath(level, tolerances: self.tolerances)
+            }
+        }
+    }
+
+    /// The number of paths levels are kept for.
+    public var count: Int {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        return pyramids.count
+    }
+
+    public func removeAll() {
+        lock.lock()
+        pyramids.removeAll()
+        generation += 1
+        lock.unlock()
+    }
+
+    /// The path to draw for pathGenerator drawn with transform to device
+    /// pixels, and whether it is a dot to fill rather than the path's own
+    /// outline, or nil if it is too small to draw.
+    internal func pathGenerator(pathGenerator: PathGenerator,
+                                transform: CGAffineTransform) -> (path: PathGenerator, isDot: Bool)? {
+        let scale = maximumScale(transform)
+        var level = tolerances.count - 1
+        while level >= 0 && tolerances[level] * scale > maximumError {
+            level -= 1
+        }
+        guard level >= 0 else {
+            return (path: pathGenerator, isDot: false)
+        }
+        let pyramid = self.pyramid(pathGenerator.cgpath, generation: .None)!
+        let deviceBounds = CGRectApplyAffineTransform(pyramid.bounds, transform)
+        if deviceBounds.width < minimumSize && deviceBounds.height < minimumSize {
+            guard drawsSmallPathsAsDots else {
+                SVGInstrumentation.count("levelOfDetail.skipped")
+                return .None
+            }
+            SVGInstrumentation.count("levelOfDetail.dots")
+            let size = scale > 0.0 ? minimumSize / scale : 0.0
+            let dot = CGRect(x: pyramid.bounds.midX - size / 2, y: pyramid.bounds.midY - size / 2,
+                             width: size, height: size)
+            return (path: SVGOutlinePath(path: CGPathCreateWithRect(dot, nil)), isDot: true)
+        }
+        SVGInstrumentation.count("levelOfDetail.level\(level)")
+        return (path: pyramid.levelPath(level, tolerances: tolerances), isDot: false)
+    }
+
+    // MARK: -
+
+    private let lock = NSLock()
+    private var pyramids = [ObjectIdentifier: PathPyramid]()
+    /// Incremented by removeAll.
+    private var generation = 0
+
+    /// The levels of path, or nil when generation is given and the levels
+    /// have been removed since it was read.
+    private func pyramid(path: CGPath, generation: Int?) -> PathPyramid? {
+        let key = ObjectIdentifier(path)
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        if let generation = generation where generation != self.generation {
+            return .None
+        }
+        if let pyramid = pyramids[key] {
+            return pyramid
+        }
+        if pyramids.count >= maximumCount {
+            pyramids.removeAll(keepCapacity: true)
+        }
+        let pyramid = PathPyramid(path: path, levelCount: tolerances.count)
+        pyramids[key] = pyramid
+        return pyramid
+    }
+}
+
+/// The levels of one path. The geometry is only read from the path when the
+/// first level is built.
+private final class PathPyramid {
+    let path: CGPath
+    let bounds: CGRect
+
+    init(path: CGPath, levelCount: Int) {
+        self.path = path
+        self.bounds = CGPathGetPathBoundingBox(path)
+        self.levels = [PathGenerator?](count: levelCount, repeatedValue: .None)
+    }
+
+    func levelPath(level: Int, tolerances: [CGFloat]) -> PathGenerator {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        if let levelPath = levels[level] {
+            return levelPath
+        }
+        let geometry = self.geometry ?? SVGPathGeometry(path: path)
+        self.geometry = geometry
+        let simplified = simplifyPathGeometry(geometry, tolerance: tolerances[level])
+        let levelPath: PathGenerator
+        if simplified.points.count == geometry.points.count {
+            // Curves and short outlines have nothing to remove.
+            levelPath = SVGOutlinePath(path: path)
+        }
+        else {
+            levelPath = SVGOutlinePath(path: simplified.makeCGPath())
+        }
+        levels[level] = levelPath
+        return levelPath
+    }
+
+    private let lock = NSLock()
+    private var levels: [PathGenerator?]
+    private var geometry: SVGPathGeometry?
+}
@@ -0,0 +1,428 @@
+//
+//  SVGPathGeometry.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+import simd
+
+import SwiftGraphics
+
+/// A compact copy of the segments of a CGPath. Each verb consumes a fixed
+/// number of points from points, in order: one for a move or a line, two for
+/// a quadratic curve, three for a cubic curve and none for close.
+public final class SVGPathGeometry {
+    public enum Verb: UInt8 {
+        case moveTo
+        case lineTo
+        case quadCurveTo
+        case curveTo
+        case closeSubpath
+
+        public var pointCount: Int {
+            switch self {
+                case .moveTo, .lineTo:
+                    return 1
+                case .quadCurveTo:
+                    return 2
+                case .curveTo:
+                    return 3
+                case .closeSubpath:
+                    return 0
+            }
+        }
+    }
+
+    public let verbs: [Verb]
+    public let points: [CGPoint]
+
+    /// The exact bounds of the path, calculated from the curve extrema and
+    /// not the control points. Matches CGPathGetPathBoundingBox.
+    public private(set) lazy var bounds: CGRect = self.calculateBounds()
+
+    public init(verbs: [Verb], points: [CGPoint]) {
+        self.verbs = verbs
+        self.points = points
+    }
+
+    public convenience init(path: CGPath) {
+        let collector = PathElementCollector()
+        withExtendedLifetime(collector) {
+            let info = UnsafeMutablePointer<Void>(Unmanaged.passUnretained(collector).toOpaque())
+            CGPathApply(path, info) { info, element in
+                let collector = Unmanaged<PathElementCollector>.fromOpaque(COpaquePointer(info)).takeUnretainedValue()
+                collector.addElement(element.memory)
+            }
+        }
+        self.init(verbs: collector.verbs, points: collector.points)
+    }
+
+    public func makeCGPath() -> CGPath {
+        let path = CGPathCreateMutable()
+        var index = 0
+        for verb in verbs {
+            switch verb {
+                case .moveTo:
+                    CGPathMoveToPoint(path, nil, points[index].x, points[index].y)
+                case .lineTo:
+                    CGPathAddLineToPoint(path, nil, points[index].x, points[index].y)
+                case .quadCurveTo:
+                    CGPathAddQuadCurveToPoint(path, nil, points[index].x, points[index].y,
+                                              points[index + 1].x, points[index + 1].y)
+                case .curveTo:
+                    CGPathAddCurveToPoint(path, nil, points[index].x, points[index].y,
+                                          points[index + 1].x, points[index + 1].y,
+                                          points[index + 2].x, points[index + 2].y)
+                case .closeSubpath:
+                    CGPathCloseSubpath(path)
+            }
+            index += verb.pointCount
+        }
+        return path
+    }
+
+    /// The geometry with each curve replaced by lines whose ends lie on it
+    /// and that stay within tolerance of it. The number of lines for a curve
+    /// comes from Wang's formula, so it grows with how sharply the curve
+    /// bends rather than with its length.
+    public func flattened(tolerance: CGFloat) -> SVGPathGeometry {
+        if !verbs.contains(.quadCurveTo) && !verbs.contains(.curveTo) {
+            return self
+        }
+        var flatVerbs = [Verb]()
+        var flatPoints = [CGPoint]()
+        flatVerbs.reserveCapacity(verbs.count)
+        flatPoints.reserveCapacity(points.count)
+
+        let maximumSegmentCount = 256
+        func segmentCount(bend: CGFloat, factor: CGFloat) -> Int {
+            guard tolerance > 0.0 && bend > 0.0 else {
+                return bend > 0.0 ? maximumSegmentCount : 1
+            }
+            return max(1, min(maximumSegmentCount, Int(ceil(sqrt(factor * bend / tolerance)))))
+        }
+        func length(x: CGFloat, _ y: CGFloat) -> CGFloat {
+            return sqrt(x * x + y * y)
+        }
+
+        var current = CGPoint.zero
+        var subpathStart = CGPoint.zero
+        var index = 0
+        for verb in verbs {
+            switch verb {
+                case .moveTo:
+                    current = points[index]
+                    subpathStart = current
+                    flatVerbs.append(.moveTo)
+                    flatPoints.append(current)
+                case .lineTo:
+                    current = points[index]
+                    flatVerbs.append(.lineTo)
+                    flatPoints.append(current)
+                case .quadCurveTo:
+                    let (p0, p1, p2) = (current, points[index], points[index + 1])
+                    let bend = length(p0.x - 2.0 * p1.x + p2.x, p0.y - 2.0 * p1.y + p2.y)
+                    let count = segmentCount(bend, factor: 0.25)
+                    for step in 1..<count {
+                        let t = CGFloat(step) / CGFloat(count)
+                        let (a, b, c) = ((1.0 - t) * (1.0 - t), 2.0 * (1.0 - t) * t, t * t)
+                        flatVerbs.append(.lineTo)
+                        flatPoints.append(CGPoint(x: a * p0.x + b * p1.x + c * p2.x,
+                                                  y: a * p0.y + b * p1.y + c * p2.y))
+                    }
+                    current = p2
+                    flatVerbs.append(.lineTo)
+                    flatPoints.append(current)
+                case .curveTo:
+                    let (p0, p1, p2, p3) = (current, points[index], points[index + 1], points[index + 2])
+                    let bend = max(length(p0.x - 2.0 * p1.x + p2.x, p0.y - 2.0 * p1.y + p2.y),
+                                   length(p1.x - 2.0 * p2.x + p3.x, p1.y - 2.0 * p2.y + p3.y))
+                    let count = segmentCount(bend, factor: 0.75)
+                    for step in 1..<count {
+                        let t = CGFloat(step) / CGFloat(count)
+                        let u = 1.0 - t
+                        let (a, b, c, d) = (u * u * u, 3.0 * u * u * t, 3.0 * u * t * t, t * t * t)
+                        flatVerbs.append(.lineTo)
+                        flatPoints.append(CGPoint(x: a * p0.x + b * p1.x + c * p2.x + d * p3.x,
+                                                  y: a * p0.y + b * p1.y + c * p2.y + d * p3.y))
+                    }
+                    current = p3
+                    flatVerbs.append(.lineTo)
+                    flatPoints.append(current)
+                case .closeSubpath:
+                    current = subpathStart
+                    flatVerbs.append(.closeSubpath)
+            }
+            index += verb.pointCount
+        }
+        return SVGPathGeometry(verbs: flatVerbs, points: flatPoints)
+    }
+
+    /// The geometry as SVG path data using absolute commands.
+    public var svgPath: String {
+        return svgPath(SVGNumberFormatter(), relative: false)
+    }
+
+    /// The geometry as SVG path data with coordinates written by formatter.
+    /// Relative commands write each point as its offset from the current
+    /// point. The offsets are taken between rounded positions so rounding
+    /// errors don't accumulate along the path.
+    public func svgPath(formatter: SVGNumberFormatter, relative: Bool) -> String {
+        var svgPath = ""
+        var current = (x: 0.0, y: 0.0)
+        var subpathStart = current
+        var index = 0
+
+        func appendPoints(count: Int) {
+            for pointIndex in index..<index + count {
+                let x = formatter.quantize(Double(points[pointIndex].x))
+                let y = formatter.quantize(Double(points[pointIndex].y))
+                if pointIndex > index {
+                    svgPath += " "
+                }
+                if relative {
+                    svgPath += formatter.format(x - current.x) + " " + formatter.format(y - current.y)
+                }
+                else {
+                    svgPath += formatter.format(x) + " " + formatter.format(y)
+                }
+            }
+            let last = points[index + count - 1]
+            current = (x: formatter.quantize(Double(last.x)), y: formatter.quantize(Double(last.y)))
+        }
+
+        for verb in verbs {
+            switch verb {
+                case .moveTo:
+                    svgPath += relative ? "m" : "M"
+                    appendPoints(1)
+                    subpathStart = current
+                case .lineTo:
+                    svgPath += relative ? "l" : "L"
+                    appendPoints(1)
+                case .quadCurveTo:
+                    svgPath += relative ? "q" : "Q"
+                    appendPoints(2)
+                case .curveTo:
+                    svgPath += relative ? "c" : "C"
+                    appendPoints(3)
+                case .closeSubpath:
+                    svgPath += relative ? "z" : "Z"
+                    current = subpathStart
+            }
+            index += verb.pointCount
+        }
+        return svgPath
+    }
+
+    // Both coordinates of a point are handled together as a double2. The end
+    // points always contribute to the bounds. A curve only needs its extrema
+    // solved for when one of its control points lies outside the bounds
+    // found so far, because a bezier curve is contained by the convex hull
+    // of its points. For most paths that skips the root finding entirely.
+    private func calculateBounds() -> CGRect {
+        if points.isEmpty {
+            return CGRect.null
+        }
+
+        var lower = double2(points[0])
+        var upper = lower
+        var current = lower
+        var subpathStart = lower
+
+        func include(point: double2) {
+            lower = min(lower, point)
+            upper = max(upper, point)
+        }
+
+        func isInside(point: double2) -> Bool {
+            return point.x >= lower.x && point.x <= upper.x && point.y >= lower.y && point.y <= upper.y
+        }
+
+        var index = 0
+        for verb in verbs {
+            switch verb {
+                case .moveTo:
+                    current = double2(points[index])
+                    subpathStart = current
+                    include(current)
+                case .lineTo:
+                    current = double2(points[index])
+                    include(current)
+                case .quadCurveTo:
+                    let p0 = current
+                    let p1 = double2(points[index])
+                    let p2 = double2(points[index + 1])
+                    include(p2)
+                    if !isInside(p1) {
+                        // B'(t) = 0 at t = (p0 - p1) / (p0 - 2p1 + p2).
+                        let numerator = p0 - p1
+                        let denominator = p0 - 2.0 * p1 + p2
+                        for lane in 0..<2 where denominator[lane] != 0.0 {
+                            let t = numerator[lane] / denominator[lane]
+                            if t > 0.0 && t < 1.0 {
+                                let mt = 1.0 - t
+                                include(mt * mt * p0 + 2.0 * mt * t * p1 + t * t * p2)
+                            }
+                        }
+                    }
+                    current = p2
+                case .curveTo:
+                    let p0 = current
+                    let p1 = double2(points[index])
+                    let p2 = double2(points[index + 1])
+                    let p3 = double2(points[index + 2])
+                    include(p3)
+                    if !(isInside(p1) && isInside(p2)) {
+                        // B'(t) / 3 = a t^2 + b t + c, solved for x and y at once.
+                        let a = 3.0 * (p1 - p2) + p3 - p0
+                        let b = 2.0 * (p0 - 2.0 * p1 + p2)
+                        let c = p1 - p0
+                        let discriminant = b * b - 4.0 * a * c
+                        for lane in 0..<2 {
+                            for t in quadraticRoots(a[lane], b: b[lane], c: c[lane],
+                                                    discriminant: discriminant[lane]) where t > 0.0 && t < 1.0 {
+                                let mt = 1.0 - t
+                                include(mt * mt * mt * p0 + 3.0 * mt * mt * t * p1
+                                        + 3.0 * mt * t * t * p2 + t * t * t * p3)
+                            }
+                        }
+                    }
+                    current = p3
+                case .closeSubpath:
+                    current = subpathStart
+            }
+            index += verb.pointCount
+        }
+        return CGRect(x: lower.x, y: lower.y, width: upper.x - lower.x, height: upper.y - lower.y)
+    }
+}
+
+private func quadraticRoots(a: Double, b: Double, c: Double, discriminant: Double) -> [Double] {
+    if abs(a) < 1.0e-12 {
+        return b == 0.0 ? [] : [-c / b]
+    }
+    if discriminant < 0.0 {
+        return []
+    }
+    let root = sqrt(discriminant)
+    return [(-b + root) / (2.0 * a), (-b - root) / (2.0 * a)]
+}
+
+private extension double2 {
+    init(_ point: CGPoint) {
+        self.init(Double(point.x), Double(point.y))
+    }
+}
+
+private final class PathElementCollector {
+    var verbs = [SVGPathGeometry.Verb]()
+    var points = [CGPoint]()
+
+    func addElement(element: CGPathElement) {
+        switch element.type {
+            case .MoveToPoint:
+                verbs.append(.moveTo)
+                points.append(element.points[0])
+            case .AddLineToPoint:
+                verbs.append(.lineTo)
+                points.append(element.points[0])
+            case .AddQuadCurveToPoint:
+                verbs.append(.quadCurveTo)
+                points.appendContentsOf([element.points[0], element.points[1]])
+            case .AddCurveToPoint:
+                verbs.append(.curveTo)
+                points.appendContentsOf([element.points[0], element.points[1], element.points[2]])
+            case .CloseSubpath:
+                verbs.append(.closeSubpath)
+        }
+    }
+}
+
+// MARK: -
+
+public extension SVGElement {
+    /// The bounds of the element's geometry in its own coordinate system,
+    /// before its transform is applied. Stroke widths are not included. The
+    /// bounds of a container are the union of the bounds of its displayed
+    /// children. Calculated once and cached until the element changes.
+    var localBounds: CGRect {
+        if let localBounds = localBoundsCache {
+            return localBounds
+        }
+        let localBounds = calculateLocalBounds()
+        localBoundsCache = localBounds
+        return localBounds
+    }
+
+    /// The bounds of the element in its parent's coordinate system.
+    var bounds: CGRect {
+        if let bounds = boundsCache {
+            return bounds
+        }
+        var bounds = localBounds
+        if let transform = transform where !bounds.isNull {
+            bounds = CGRectApplyAffineTransform(bounds, transform.toCGAffineTransform())
+        }
+        boundsCache = bounds
+        return bounds
+    }
+
+    private func calculateLocalBounds() -> CGRect {
+        switch self {
+            case let container as SVGContainer:
+                return container.children.reduce(CGRect.null) {
+                    $1.display ? CGRectUnion($0, $1.bounds) : $0
+                }
+            case let path as SVGPath:
+                return path.source.geometry.bounds
+            case let pathGenerator as PathGenerator:
+                return SVGPathGeometry(path: pathGenerator.cgpath).bounds
+            case let use as SVGUse:
+                return use.referencedElement.display ? use.referencedElement.bounds : CGRect.null
+            case let text as SVGSimpleText:
+                return text.spans.reduce(CGRect.null) { CGRectUnion($0, $1.bounds) }
+            default:
+                return CGRect.null
+        }
+    }
+}
+
+/// Geometry generated while rendering, like text and stroke outlines, drawn
+/// like a path element. It is filled with the non-zero winding rule.
+public final class SVGOutlinePath: PathGenerator {
+    public private(set) lazy var geometry: SVGPathGeometry = SVGPathGeometry(path: self.cgpath)
+    public private(set) lazy var cgpath: CGPath = self.geometry.makeCGPath()
+    public private(set) lazy var svgpath: String? = self.geometry.svgPath
+    public var mipath: MovingImagesPath? { get { return .None } }
+    public var evenOdd: Bool {
+        get { return false }
+        set { }
+    }
+
+    public init(geometry: SVGPathGeometry) {
+        self.geometry = geometry
+    }
+
+    public init(path: CGPath) {
+        self.cgpath = path
+    }
+}
+
+extension SVGTextSpan {
+    /// The typographic bounds of the span. Text is drawn flipped about its
+    /// baseline so the line bounds are flipped to match.
+    var bounds: CGRect {
+        let line = CTLineCreateWithAttributedString(cttext)
+        let lineBounds = CTLineGetBoundsWithOptions(line, CTLineBoundsOptions(rawValue: 0))
+        var bounds = CGRect(x: textOrigin.x + lineBounds.minX, y: textOrigin.y - lineBounds.maxY,
+                            width: lineBounds.width, height: lineBounds.height)
+        if let transform = transform {
+            bounds = CGRectApplyAffineTransform(bounds, transform.toCGAffineTransform())
+        }
+        return bounds
+    }
+}
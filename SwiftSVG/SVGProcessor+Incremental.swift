@@ -0,0 +1,213 @@
+//
+//  SVGProcessor+Incremental.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+/// 64 bit FNV-1a.
+internal struct FNV1aHash {
+    private(set) var value: UInt64 = 0xcbf29ce484222325
+
+    mutating func addByte(byte: UInt8) {
+        value = (value ^ UInt64(byte)) &* 0x100000001b3
+    }
+
+    /// Adds the UTF-8 of string followed by a byte that can't appear in
+    /// UTF-8, so that "ab", "c" and "a", "bc" hash differently.
+    mutating func addString(string: String) {
+        for byte in string.utf8 {
+            addByte(byte)
+        }
+        addByte(0xff)
+    }
+
+    mutating func addWord(word: UInt64) {
+        for shift in UInt64(0).stride(to: 64, by: 8) {
+            addByte(UInt8(truncatingBitPattern: word >> shift))
+        }
+    }
+}
+
+/// The hash of an element in the source and everything inside it, taken
+/// before processing as processing removes the attributes it handles.
+internal struct SVGSubtreeDigest {
+    let hash: UInt64
+    /// False when something inside refers to another element by id, as what
+    /// it refers to can change without the subtree changing, or when it sets
+    /// document properties like the title.
+    let reusable: Bool
+    // Keeps the element alive so its identifier isn't reused while the
+    // digests are looked up by it.
+    let xmlElement: NSXMLElement
+}
+
+/// The elements of the last document processed, by the hash of the source
+/// they came from.
+internal final class SVGSubtreeCache {
+    let arcTolerance: CGFloat
+    var document: SVGDocument?
+    var generation = 0
+    var elementsByHash: [UInt64: [SVGElement]] = [: ]
+    var hashesByElement: [ObjectIdentifier: UInt64] = [: ]
+    /// How long each element took to process with everything inside it,
+    /// kept with the element when it is reused.
+    var durationsByElement: [ObjectIdentifier: CFTimeInterval] = [: ]
+
+    init(arcTolerance: CGFloat) {
+        self.arcTolerance = arcTolerance
+    }
+
+    func record(element: SVGElement, hash: UInt64, duration: CFTimeInterval) {
+        elementsByHash[hash] = (elementsByHash[hash] ?? []) + [element]
+        hashesByElement[ObjectIdentifier(element)] = hash
+        durationsByElement[ObjectIdentifier(element)] = duration
+    }
+
+    /// Removes and returns an element for hash. Identical subtrees each get
+    /// their own element.
+    func take(hash: UInt64) -> SVGElement? {
+        guard var elements = elementsByHash[hash], let element = elements.popLast() else {
+            return .None
+        }
+        elementsByHash[hash] = elements.isEmpty ? .None : elements
+        return element
+    }
+}
+
+internal extension SVGProcessor {
+
+    /// Hashes every element under xmlElement bottom up.
+    func digestSubtrees(xmlElement: NSXMLElement, inout digests: [ObjectIdentifier: SVGSubtreeDigest]) -> SVGSubtreeDigest {
+        var hash = FNV1aHash()
+        var reusable = true
+        hash.addString(xmlElement.name ?? "")
+        switch xmlElement.name ?? "" {
+            case "title", "desc", "use", "symbol", "defs", "svg":
+                reusable = false
+            default:
+                break
+        }
+
+        // Attributes are sorted so that reordering them isn't a change.
+        let attributes = (xmlElement.attributes ?? []).map() {
+            (name: $0.name ?? "", value: $0.stringValue ?? "")
+        }
+        for attribute in attributes.sort({ $0.name < $1.name }) {
+            hash.addString(attribute.name)
+            hash.addString(attribute.value)
+            if attribute.name.hasSuffix("href") || attribute.value.containsString("url(") {
+                reusable = false
+            }
+        }
+
+        for node in xmlElement.children ?? [] {
+            if let child = node as? NSXMLElement {
+                let digest = digestSubtrees(child, digests: &digests)
+                hash.addByte(0x01)
+                hash.addWord(digest.hash)
+                reusable = reusable && digest.reusable
+            }
+            else if node.kind == .TextKind {
+                hash.addByte(0x02)
+                hash.addString(node.stringValue ?? "")
+            }
+        }
+        let digest = SVGSubtreeDigest(hash: hash.value, reusable: reusable, xmlElement: xmlElement)
+        digests[ObjectIdentifier(xmlElement)] = digest
+        return digest
+    }
+
+    /// The hash of xmlElement's subtree in the context it's being processed
+    /// in, or nil if what it becomes can't be reused.
+    func subtreeHash(xmlElement: NSXMLElement, state: State) -> UInt64? {
+        guard state.processedSubtrees != nil && state.materializingSymbol == nil,
+            let digest = state.subtreeDigests[ObjectIdentifier(xmlElement)] where digest.reusable else {
+            return .None
+        }
+        // Opacities are inherited from ancestors while processing.
+        var hash = FNV1aHash()
+        hash.addWord(digest.hash)
+        for opacity in [state.fillOpacity, state.strokeOpacity] {
+            hash.addWord(opacity.map({ unsafeBitCast(Double($0), UInt64.self) }) ?? UInt64.max)
+        }
+        return hash.value
+    }
+
+    /// An element made from an identical subtree in the previous document,
+    /// with every element inside it registered and counted as if it had just
+    /// been processed from xmlElement.
+    func reuseSubtree(hash: UInt64, xmlElement: NSXMLElement, state: State) -> SVGElement? {
+        guard let previousSubtrees = state.previousSubtrees, let processedSubtrees = state.processedSubtrees,
+            let element = previousSubtrees.take(hash) else {
+            return .None
+        }
+
+        var elements = [SVGElement]()
+        collectElements(element, elements: &elements)
+        // An id inside the subtree that has already been used means an element
+        // has been processed for it ahead of time, which this one would hide.
+        for descendant in elements {
+            if let id = descendant.id where state.elementsByID[id] != nil {
+                // Put back as it was taken.
+                previousSubtrees.record(element, hash: hash,
+                    duration: previousSubtrees.durationsByElement[ObjectIdentifier(element)] ?? 0.0)
+                return .None
+            }
+        }
+        for descendant in elements {
+            if let id = descendant.id {
+                state.elementsByID[id] = descendant
+            }
+            let identifier = ObjectIdentifier(descendant)
+            if let descendantHash = previousSubtrees.hashesByElement[identifier] {
+                processedSubtrees.record(descendant, hash: descendantHash,
+                    duration: previousSubtrees.durationsByElement[identifier] ?? 0.0)
+            }
+        }
+        state.reusedElementCount += elements.count
+        state.reuseTimeSaved += previousSubtrees.durationsByElement[ObjectIdentifier(element)] ?? 0.0
+        SVGInstrumentation.count("reuse.elements", by: elements.count)
+        countSubtree(xmlElement, state: state)
+        return element
+    }
+
+    /// Counts the source elements of a reused subtree the way processing
+    /// them would have.
+    private func countSubtree(xmlElement: NSXMLElement, state: State) {
+        state.processedElementCount += 1
+        SVGInstrumentation.count("elements." + (xmlElement.name ?? ""))
+        for node in xmlElement.children ?? [] {
+            if let child = node as? NSXMLElement {
+                countSubtree(child, state: state)
+            }
+        }
+    }
+}
+
+internal extension SVGDocument {
+    /// Empties a document whose elements have been moved into a newer one,
+    /// leaving the elements that weren't reused without a document.
+    func invalidate() {
+        func detach(container: SVGContainer) {
+            for case let child as SVGContainer in container.children where child.parent === container {
+                detach(child)
+            }
+            container.children = []
+        }
+        detach(self)
+        isInvalidated = true
+    }
+}
+
+private func collectElements(element: SVGElement, inout elements: [SVGElement]) {
+    elements.append(element)
+    if let container = element as? SVGContainer {
+        for child in container.children {
+            collectElements(child, elements: &elements)
+        }
+    }
+}
@@ -45,7 +45,27 @@ public class SVGProcessor {
 
     public class State {
         var document: SVGDocument?
+        weak var processor: SVGProcessor?
+        var rootXMLElement: NSXMLElement?
         var elementsByID: [String:SVGElement] = [: ]
+        /// Elements inside defs and symbols, and forward references, indexed
+        /// by id but not yet processed.
+        var definitionsByID: [String:NSXMLElement] = [: ]
+        /// Elements processed ahead of their place in the document because
+        /// they were referenced first.
+        var materializedElements: [ObjectIdentifier:SVGElement] = [: ]
+        var elementsInProgress = Set<ObjectIdentifier>()
+        var materializingSymbol: NSXMLElement?
+        var documentIndexed = false
+        var processedElementCount = 0
+        var deferredElementCount = 0
+        var materializedElementCount = 0
+        /// Set when processing incrementally.
+        var subtreeDigests: [ObjectIdentifier:SVGSubtreeDigest] = [: ]
+        var previousSubtrees: SVGSubtreeCache?
+        var processedSubtrees: SVGSubtreeCache?
+        var reusedElementCount = 0
+        var reuseTimeSaved: CFTimeInterval = 0.0
         var events: [Event] = []
         var fillOpacity: CGFloat?
         var strokeOpacity: CGFloat?
@@ -71,11 +91,84 @@ public class SVGProcessor {
         case invalidFunctionParameters(String, String, Int)
     }
 
+    /// The largest distance in document units between an arc in a path and
+    /// the curves that approximate it. For output drawn at a known scale use
+    /// the device tolerance divided by that scale.
+    public var arcTolerance: CGFloat = MI_SVGDefaultArcTolerance
+
+    /// When true each document processed reuses the elements of the previous
+    /// one wherever a subtree of the source is unchanged, along with
+    /// everything cached on them. Subtrees that refer to other elements by id
+    /// are always processed again. Reused elements are moved into the new
+    /// document, so when anything is reused the previous document is emptied
+    /// and marked as invalidated.
+    public var incremental = false {
+        didSet {
+            if !incremental {
+                subtreeCache = .None
+            }
+        }
+    }
+
+    internal var subtreeCache: SVGSubtreeCache?
+
+    /// The number of elements the last document processed took from the
+    /// previous one, included in its count of elements.
+    public private(set) var reusedElementCount = 0
+
+    /// How long processing the reused elements took when they were first
+    /// processed, which is the time incremental processing saved on the last
+    /// document.
+    public private(set) var reuseTimeSaved: CFTimeInterval = 0.0
+
     public init() {
     }
 
+    /// Logs message, adds it to the state's events and counts the warning by
+    /// kind.
+    private func warning(kind: String, @autoclosure message: () -> String, state: State) {
+        let text = message()
+        SVGInstrumentation.count("warnings." + kind)
+        SVGLog.warning(text)
+        state.events.append(Event(severity: .warning, message: text))
+    }
+
+    internal static func countPathSegments(path: CGPath) {
+        guard SVGInstrumentation.enabled else {
+            return
+        }
+        let verbs = SVGPathGeometry(path: path).verbs
+        for verb in verbs {
+            switch verb {
+                case .moveTo:
+                    SVGInstrumentation.count("segments.moveTo")
+                case .lineTo:
+                    SVGInstrumentation.count("segments.lineTo")
+                case .quadCurveTo:
+                    SVGInstrumentation.count("segments.quadCurveTo")
+                case .curveTo:
+                    SVGInstrumentation.count("segments.curveTo")
+                case .closeSubpath:
+                    SVGInstrumentation.count("segments.closeSubpath")
+            }
+        }
+        SVGInstrumentation.record("pathSegments", value: Double(verbs.count))
+    }
+
+    private func countPointListSegments(points: [CGPoint], closed: Bool) {
+        guard SVGInstrumentation.enabled && !points.isEmpty else {
+            return
+        }
+        SVGInstrumentation.count("segments.moveTo")
+        SVGInstrumentation.count("segments.lineTo", by: points.count - 1)
+        if closed {
+            SVGInstrumentation.count("segments.closeSubpath")
+        }
+        SVGInstrumentation.record("pathSegments", value: Double(points.count + (closed ? 1 : 0)))
+    }
+
     private func isElementRendereable(svgElement: SVGElement?) -> Bool {
-        if let _ = svgElement as? SVGLinearGradient {
+        if let _ = svgElement as? SVGGradient {
             return false
         }
         return true
@@ -84,18 +177,65 @@ public class SVGProcessor {
     public func processXMLDocument(xmlDocument: NSXMLDocument) throws -> SVGDocument? {
         let rootElement = xmlDocument.rootElement()!
         let state = State()
-        let document = try self.processSVGElement(rootElement, state: state) as? SVGDocument
-        if state.events.count > 0 {
-            for event in state.events {
-                print(event)
+        if incremental {
+            digestSubtrees(rootElement, digests: &state.subtreeDigests)
+            // Nothing is reused if the previous document has been changed since.
+            if let cache = subtreeCache, let previousDocument = cache.document
+                where previousDocument.generation == cache.generation && cache.arcTolerance == arcTolerance {
+                state.previousSubtrees = cache
             }
+            state.processedSubtrees = SVGSubtreeCache(arcTolerance: arcTolerance)
+        }
+        defer {
+            // Even when processing fails, as the reused elements have been moved.
+            if state.reusedElementCount > 0 {
+                state.previousSubtrees?.document?.invalidate()
+            }
+        }
+        let document = try SVGInstrumentation.time(.elements) {
+            try self.processSVGElement(rootElement, state: state) as? SVGDocument
+        }
+        if let processedSubtrees = state.processedSubtrees {
+            processedSubtrees.document = document
+            processedSubtrees.generation = document?.generation ?? 0
+            subtreeCache = processedSubtrees
+            reusedElementCount = state.reusedElementCount
+            reuseTimeSaved = state.reuseTimeSaved
+            SVGLog.debug("Reused \(state.reusedElementCount) of \(state.processedElementCount) elements, " +
+                "saving \(Int(state.reuseTimeSaved * 1000.0)) ms")
+        }
+        if state.deferredElementCount > 0 {
+            SVGLog.debug("Deferred \(state.deferredElementCount) elements in definitions, " +
+                "materialized \(state.materializedElementCount), " +
+                "skipped \(max(0, state.deferredElementCount - state.materializedElementCount))")
         }
         return document
     }
 
+    /// Maps the file at url into memory rather than reading it into a string.
+    /// The XML parser reads UTF-8 bytes from the mapping directly and only
+    /// transcodes a file declared with another encoding. NSXMLDocument still
+    /// copies every attribute value into a string of its own, so numbers are
+    /// scanned from those strings and not from the mapping.
+    public func processFileURL(url: NSURL) throws -> SVGDocument? {
+        let data = try NSData(contentsOfURL: url, options: .DataReadingMappedIfSafe)
+        return try self.processData(data)
+    }
+
+    public func processData(data: NSData) throws -> SVGDocument? {
+        SVGInstrumentation.count("bytes.in", by: data.length)
+        let xmlDocument = try SVGInstrumentation.time(.xml) {
+            try NSXMLDocument(data: data, options: 0)
+        }
+        return try self.processXMLDocument(xmlDocument)
+    }
+
     public func processSVGDocument(xmlElement: NSXMLElement, state: State) throws -> SVGDocument {
         let document = SVGDocument()
+        document.geometryStore = SVGGeometryStore(arcTolerance: arcTolerance)
         state.document = document
+        state.processor = self
+        state.rootXMLElement = state.rootXMLElement ?? xmlElement
 
         // Version.
         if let version = xmlElement["version"]?.stringValue {
@@ -172,6 +312,30 @@ public class SVGProcessor {
             throw Error.corruptXML(#file, #function, #line)
         }
 
+        let elementIdentifier = ObjectIdentifier(xmlElement)
+        if let svgElement = state.materializedElements.removeValueForKey(elementIdentifier) {
+            // Already processed because it was referenced before this point.
+            return name == "symbol" || !self.isElementRendereable(svgElement) ? .None : svgElement
+        }
+        let subtreeHash = self.subtreeHash(xmlElement, state: state)
+        if let subtreeHash = subtreeHash,
+            let svgElement = reuseSubtree(subtreeHash, xmlElement: xmlElement, state: state) {
+            return svgElement
+        }
+        let startTime = subtreeHash == nil ? 0.0 : CFAbsoluteTimeGetCurrent()
+        state.processedElementCount += 1
+        SVGInstrumentation.count("elements." + name)
+        state.elementsInProgress.insert(elementIdentifier)
+        defer {
+            state.elementsInProgress.remove(elementIdentifier)
+        }
+
+        // Fill and stroke opacity are inherited, so are set before the
+        // children are processed.
+        let opacities = try SVGProcessor.opacities(xmlElement)
+        state.fillOpacity = opacities.fill ?? state.fillOpacity
+        state.strokeOpacity = opacities.stroke ?? state.strokeOpacity
+
         switch name {
             case "defs":
                 svgElement = try processDEFS(xmlElement, state: state)
@@ -181,7 +345,13 @@ public class SVGProcessor {
                 svgElement = try processSVGGroup(xmlElement, state: state)
             // The "symbol" element being equated to a group element here is a pure hack.
             // TODO: create a SVGSymbol class and a processSVGSymbol method.
+            // Symbols are only drawn through a use element so they are indexed
+            // where they appear and processed when first referenced.
             case "symbol":
+                guard xmlElement === state.materializingSymbol else {
+                    state.deferredElementCount += indexDefinitions(xmlElement, state: state)
+                    return .None
+                }
                 svgElement = try processSVGGroup(xmlElement, state: state)
             case "path":
                 svgElement = try processSVGPath(xmlElement, state: state)
@@ -203,40 +373,56 @@ public class SVGProcessor {
                 svgElement = try processUSEElement(xmlElement, state:state)
             case "linearGradient":
                 svgElement = try processGradientDefs(xmlElement, state:state)
+            case "radialGradient":
+                svgElement = try processRadialGradientDefs(xmlElement, state:state)
             case "title":
                 state.document!.title = xmlElement.stringValue as String?
             case "desc":
                 state.document!.documentDescription = xmlElement.stringValue as String?
             default:
-                state.events.append(Event(severity: .warning, message: "Unhandled element \(xmlElement.name)"))
+                warning("unhandledElement", message: "Unhandled element \(name)", state: state)
                 return nil
         }
 
         if let svgElement = svgElement {
-            svgElement.textStyle = try processTextStyle(xmlElement)
-            svgElement.style = try processStyle(xmlElement, state: state, svgElement: svgElement)
+            try SVGInstrumentation.time(.style) {
+                svgElement.textStyle = try self.processTextStyle(xmlElement)
+                svgElement.style = try self.processStyle(xmlElement, state: state, svgElement: svgElement)
+            }
+            let transform = try SVGInstrumentation.time(.transforms) {
+                try self.processTransform(xmlElement, elementKey: "transform")
+            }
             if let theTransform = svgElement.transform {
-                if let newTransform = try processTransform(xmlElement, elementKey: "transform") {
+                if let newTransform = transform {
                     // svgElement.transform = theTransform + newTransform
                     svgElement.transform = newTransform + theTransform
                 }
             }
             else {
-                svgElement.transform = try processTransform(xmlElement, elementKey: "transform")
+                svgElement.transform = transform
             }
 
             if let id = xmlElement["id"]?.stringValue {
                 svgElement.id = id
                 if state.elementsByID[id] != nil {
-                    state.events.append(Event(severity: .warning, message: "Duplicate elements with id \"\(id)\"."))
+                    warning("duplicateID", message: "Duplicate elements with id \"\(id)\".", state: state)
                 }
                 state.elementsByID[id] = svgElement
                 xmlElement["id"] = nil
             }
 
-            if xmlElement.attributes?.count > 0 {
-                state.events.append(Event(severity: .warning, message: "Unhandled attributes: \(xmlElement))"))
-                svgElement.xmlElement = xmlElement
+            if let attributes = xmlElement.attributes where attributes.count > 0 {
+                var unhandledAttributes = [String: String]()
+                for attribute in attributes {
+                    if let attributeName = attribute.name {
+                        unhandledAttributes[attributeName] = attribute.stringValue ?? ""
+                        SVGInstrumentation.count("unhandledAttributes." + attributeName)
+                    }
+                }
+                svgElement.unhandledAttributes = unhandledAttributes
+                warning("unhandledAttributes",
+                        message: "Unhandled attributes of \(name): \(unhandledAttributes.keys.sort().joinWithSeparator(", "))",
+                        state: state)
             }
         }
         
@@ -246,26 +432,150 @@ public class SVGProcessor {
             svgElement = .None
         }
 
+        if let svgElement = svgElement, let subtreeHash = subtreeHash {
+            state.processedSubtrees?.record(svgElement, hash: subtreeHash,
+                duration: CFAbsoluteTimeGetCurrent() - startTime)
+        }
         return svgElement
     }
 
     public func processDEFS(xmlElement: NSXMLElement, state: State) throws -> SVGElement? {
         // A def element can be children of documents and groups.
         // Any member of def elements should be accessible anywhere within the SVGDocument.
+        // Members are only indexed here and processed when first referenced,
+        // so definitions that are never used are never built.
         guard let nodes = xmlElement.children else {
             return .None
         }
-        
-        // I suspect that we might need a seperate processor for members of the defs element.
-        var defElements = [SVGElement]()
         for node in nodes where node is NSXMLElement {
-            if let svgElement = try self.processSVGElement(node as! NSXMLElement, state: state) {
-                defElements.append(svgElement)
-            }
+            state.deferredElementCount += indexDefinitions(node as! NSXMLElement, state: state)
         }
         return nil
     }
 
+    /// Returns the element with id, processing it first if it is a definition
+    /// that has not been referenced before or is defined later in the document.
+    public func elementWithID(id: String, state: State) throws -> SVGElement? {
+        if let svgElement = state.elementsByID[id] {
+            return svgElement
+        }
+        if state.definitionsByID[id] == nil && !state.documentIndexed {
+            // A forward reference. Index everything not yet processed, once.
+            state.documentIndexed = true
+            if let rootXMLElement = state.rootXMLElement {
+                indexDefinitions(rootXMLElement, state: state)
+            }
+        }
+        guard let xmlElement = state.definitionsByID.removeValueForKey(id) else {
+            return .None
+        }
+        guard !state.elementsInProgress.contains(ObjectIdentifier(xmlElement)) else {
+            warning("circularReference", message: "Circular reference to element with id: \(id)", state: state)
+            return .None
+        }
+
+        // The element inherits the opacities of where it is in the document,
+        // not of where it is used. Definitions inherit none.
+        let oldFillOpacity = state.fillOpacity
+        let oldStrokeOpacity = state.strokeOpacity
+        let oldMaterializingSymbol = state.materializingSymbol
+        let inheritedOpacities = try SVGProcessor.inheritedOpacities(xmlElement)
+        state.fillOpacity = inheritedOpacities.fill
+        state.strokeOpacity = inheritedOpacities.stroke
+        state.materializingSymbol = xmlElement
+        defer {
+            state.fillOpacity = oldFillOpacity
+            state.strokeOpacity = oldStrokeOpacity
+            state.materializingSymbol = oldMaterializingSymbol
+        }
+
+        let processedElementCount = state.processedElementCount
+        try self.processSVGElement(xmlElement, state: state)
+        if oldMaterializingSymbol == nil {
+            state.materializedElementCount += state.processedElementCount - processedElementCount
+        }
+        guard let svgElement = state.elementsByID[id] else {
+            return .None
+        }
+        state.materializedElements[ObjectIdentifier(xmlElement)] = svgElement
+        return svgElement
+    }
+
+    /// The fill and stroke opacities xmlElement sets itself, with the
+    /// attributes taking precedence over the style attribute as they do
+    /// when the style is processed. Nothing is removed.
+    private static func opacities(xmlElement: NSXMLElement) throws -> (fill: CGFloat?, stroke: CGFloat?) {
+        var fill: CGFloat? = .None
+        var stroke: CGFloat? = .None
+        if let style = xmlElement["style"]?.stringValue where style.containsString("-opacity") {
+            let trimChars = NSCharacterSet.whitespaceAndNewlineCharacterSet()
+            for part in style.componentsSeparatedByString(";") {
+                let pair = part.componentsSeparatedByString(":")
+                if pair.count != 2 {
+                    continue
+                }
+                let value = pair[1].stringByTrimmingCharactersInSet(trimChars)
+                switch pair[0].stringByTrimmingCharactersInSet(trimChars) {
+                    case "fill-opacity":
+                        fill = try SVGProcessor.stringToCGFloat(value)
+                    case "stroke-opacity":
+                        stroke = try SVGProcessor.stringToCGFloat(value)
+                    default:
+                        break
+                }
+            }
+        }
+        if let value = try SVGProcessor.stringToOptionalCGFloat(xmlElement["fill-opacity"]?.stringValue) {
+            fill = value
+        }
+        if let value = try SVGProcessor.stringToOptionalCGFloat(xmlElement["stroke-opacity"]?.stringValue) {
+            stroke = value
+        }
+        return (fill: fill, stroke: stroke)
+    }
+
+    /// The opacities xmlElement inherits from its ancestors in the source, or
+    /// none if it is inside defs or is or is inside a symbol. Ancestors being
+    /// processed keep their attributes until their children are done.
+    private static func inheritedOpacities(xmlElement: NSXMLElement) throws -> (fill: CGFloat?, stroke: CGFloat?) {
+        var ancestors = [NSXMLElement]()
+        var element: NSXMLElement? = xmlElement
+        while let current = element {
+            if current.name == "defs" || current.name == "symbol" {
+                return (fill: .None, stroke: .None)
+            }
+            if current !== xmlElement {
+                ancestors.append(current)
+            }
+            element = current.parent as? NSXMLElement
+        }
+        var fill: CGFloat? = .None
+        var stroke: CGFloat? = .None
+        for ancestor in ancestors {
+            let opacities = try SVGProcessor.opacities(ancestor)
+            fill = fill ?? opacities.fill
+            stroke = stroke ?? opacities.stroke
+            if fill != nil && stroke != nil {
+                break
+            }
+        }
+        return (fill: fill, stroke: stroke)
+    }
+
+    /// Indexes xmlElement and its descendants by id, returning how many elements were visited.
+    private func indexDefinitions(xmlElement: NSXMLElement, state: State) -> Int {
+        if let id = xmlElement["id"]?.stringValue where state.definitionsByID[id] == nil {
+            state.definitionsByID[id] = xmlElement
+        }
+        var count = 1
+        if let nodes = xmlElement.children {
+            for node in nodes where node is NSXMLElement {
+                count += indexDefinitions(node as! NSXMLElement, state: state)
+            }
+        }
+        return count
+    }
+
     public func processUSEElement(xmlElement: NSXMLElement, state: State) throws -> SVGElement? {
         guard let string = xmlElement["xlink:href"]?.stringValue where string.characters.count > 1 else {
             throw Error.corruptXML(#file, #function, #line)
@@ -276,24 +586,25 @@ public class SVGProcessor {
         }
         
         let subString = string.substringFromIndex(string.startIndex.successor())
-        guard let element = state.elementsByID[subString] else {
+        guard let element = try elementWithID(subString, state: state) else {
             // print("We don't have a use element for id: \(subString)")
-            state.events.append(Event(severity: .warning, message: "Could not find element with id: \(subString)"))
+            warning("missingReference", message: "Could not find element with id: \(subString)", state: state)
             return .None
         }
         // print("We have a use element for id: \(subString)")
         // print("Element is: \(element)")
         xmlElement["xlink:href"] = nil
+        // The referenced element is shared by every use of it rather than
+        // being moved to wherever it was last used.
+        let use = SVGUse(referencedElement: element)
         let ox = try SVGProcessor.stringToOptionalCGFloat(xmlElement["x"]?.stringValue)
         let oy = try SVGProcessor.stringToOptionalCGFloat(xmlElement["y"]?.stringValue)
-        if let x = ox, let y = oy {
-            let group = SVGGroup(children: [element])
-            group.transform = Translate(tx: x, ty: y)
+        if ox != nil || oy != nil {
+            use.transform = Translate(tx: ox ?? 0.0, ty: oy ?? 0.0)
             xmlElement["x"] = nil
             xmlElement["y"] = nil
-            return group
         }
-        return element
+        return use
     }
 
     public func processSVGGroup(xmlElement: NSXMLElement, state: State) throws -> SVGGroup? {
@@ -318,18 +629,23 @@ public class SVGProcessor {
             throw Error.expectedSVGElementNotFound(#file, #function, #line)
         }
 
-        var pathArray = NSMutableArray(capacity: 0)
-        let path = MICGPathCreateFromSVGPath(string, pathArray: &pathArray)
         xmlElement["d"] = nil
-        let svgElement = SVGPath(path: path, svgPath: string)
-        return svgElement
+        guard let store = state.document?.geometryStore else {
+            return SVGPath(source: SVGPathSource(svgPath: string, arcTolerance: arcTolerance))
+        }
+        // Elements with the same path data share its geometry.
+        let source = store.source(string)
+        return SVGPath(source: source)
     }
 
     public func processSVGPolygon(xmlElement: NSXMLElement, state: State) throws -> SVGPolygon? {
         guard let pointsString = xmlElement["points"]?.stringValue else {
             throw Error.expectedSVGElementNotFound(#file, #function, #line)
         }
-        let points = try SVGProcessor.parseListOfPoints(pointsString)
+        let points = try SVGInstrumentation.time(.paths) {
+            try SVGProcessor.parseListOfPoints(pointsString)
+        }
+        countPointListSegments(points, closed: true)
         
         xmlElement["points"] = nil
         let svgElement = SVGPolygon(points: points)
@@ -340,7 +656,10 @@ public class SVGProcessor {
         guard let pointsString = xmlElement["points"]?.stringValue else {
             throw Error.expectedSVGElementNotFound(#file, #function, #line)
         }
-        let points = try SVGProcessor.parseListOfPoints(pointsString)
+        let points = try SVGInstrumentation.time(.paths) {
+            try SVGProcessor.parseListOfPoints(pointsString)
+        }
+        countPointListSegments(points, closed: false)
         
         xmlElement["points"] = nil
         let svgElement = SVGPolyline(points: points)
@@ -515,7 +834,7 @@ public class SVGProcessor {
         return nil
     }
     
-    private class func processFillColor(colorString: String, svgElement: SVGElement, state: State?) -> StyleElement? {
+    private class func processFillColor(colorString: String, svgElement: SVGElement, state: State?) throws -> StyleElement? {
         if colorString == "none" {
             svgElement.drawFill = false
             return nil
@@ -524,13 +843,18 @@ public class SVGProcessor {
         if colorString.hasPrefix("url(#") {
             let string = colorString.substringFromIndex(colorString.startIndex.advancedBy(5))
             let gradientString = string.substringToIndex(string.endIndex.advancedBy(-1))
-            let gradientElement = state?.elementsByID[gradientString] as? SVGLinearGradient
+            var gradientElement: SVGGradient? = .None
+            if let state = state, let processor = state.processor {
+                gradientElement = try processor.elementWithID(gradientString, state: state) as? SVGGradient
+            }
 
             if let gradient = gradientElement {
+                // Resolve the inheritance chain now so rendering doesn't have to.
+                let _ = gradient.coalesceGradientInheritance()
                 svgElement.gradientFill = gradient
             }
             else {
-                print("Identifier did not refer to a linear gradient")
+                SVGLog.warning("Identifier \(gradientString) did not refer to a gradient")
                 return StyleElement.Alpha(0.0)
             }
             return .None
@@ -645,7 +969,7 @@ public class SVGProcessor {
             }
         }
         if let color = fillColor {
-            if let styleElement = SVGProcessor.processFillColor(color, svgElement: svgElement, state:state) {
+            if let styleElement = try SVGProcessor.processFillColor(color, svgElement: svgElement, state:state) {
                 styleElements.append(styleElement)
             }
         }
@@ -706,7 +1030,7 @@ public class SVGProcessor {
 
         if let value = xmlElement["fill"]?.stringValue,
             let svgElement = svgElement {
-            if let styleElement = SVGProcessor.processFillColor(value, svgElement: svgElement, state:state) {
+            if let styleElement = try SVGProcessor.processFillColor(value, svgElement: svgElement, state:state) {
                 styleElements.append(styleElement)
             }
             xmlElement["fill"] = nil
@@ -821,14 +1145,25 @@ public class SVGProcessor {
         return transform
     }
 
-    private func processInheritedGradient(xmlElement: NSXMLElement, elementKey: String, state: State) -> SVGLinearGradient? {
+    private func processInheritedGradient(xmlElement: NSXMLElement, elementKey: String, state: State) throws -> SVGGradient? {
         guard let value = xmlElement[elementKey]?.stringValue else {
-            print("No key for inherited gradient")
+            SVGLog.debug("No key for inherited gradient")
             return nil
         }
-        print("Key for inherited gradient is: \(value)")
+        SVGLog.debug("Key for inherited gradient is: \(value)")
         xmlElement[elementKey] = nil
-        return state.elementsByID[value.substringFromIndex(value.startIndex.advancedBy(1))] as? SVGLinearGradient
+        return try elementWithID(value.substringFromIndex(value.startIndex.advancedBy(1)), state: state) as? SVGGradient
+    }
+
+    private func processSpreadMethod(xmlElement: NSXMLElement) throws -> SVGSpreadMethod? {
+        guard let value = xmlElement["spreadMethod"]?.stringValue else {
+            return .None
+        }
+        guard let spreadMethod = SVGSpreadMethod(rawValue: value) else {
+            throw Error.invalidSVG(#file, #function, #line)
+        }
+        xmlElement["spreadMethod"] = nil
+        return spreadMethod
     }
 
     private func processGradientStop(xmlElement: NSXMLElement) throws -> SVGGradientStop {
@@ -862,7 +1197,7 @@ public class SVGProcessor {
                         stopOpacity = try SVGProcessor.stringToCGFloat(value, defaultVal: 1.0)
                     
                     default:
-                        print("Unhandled stop property \(propertyName)")
+                        SVGLog.warning("Unhandled stop property \(propertyName)")
                         break
                 }
             }
@@ -937,19 +1272,58 @@ public class SVGProcessor {
         let point1 = SVGProcessor.makeOptionalPoint(x: x1, y: y1)
         let point2 = SVGProcessor.makeOptionalPoint(x: x2, y: y2)
         
+        let spreadMethod = try processSpreadMethod(xmlElement)
         let gradientTransform = try processTransform(xmlElement, elementKey: "gradientTransform")
-        let inherited: SVGLinearGradient?
+        let inherited: SVGGradient?
         if let _ = xmlElement["xlink:href"]?.stringValue {
-            inherited = processInheritedGradient(xmlElement, elementKey: "xlink:href", state: state)
+            inherited = try processInheritedGradient(xmlElement, elementKey: "xlink:href", state: state)
         }
         else {
             inherited = nil
         }
-        print("In process gradient defs")
-        return SVGLinearGradient(stops: stops, gradientUnit: gradientUnit,
+        return SVGLinearGradient(stops: stops, gradientUnit: gradientUnit, spreadMethod: spreadMethod,
                                  point1: point1, point2: point2,
                                  transform: gradientTransform, inherited: inherited)
     }
+
+    public func processRadialGradientDefs(xmlElement: NSXMLElement, state: State) throws -> SVGRadialGradient? {
+        let stops = try processGradientStops(xmlElement.children)
+        let cx = try SVGProcessor.stringToOptionalCGFloat(xmlElement["cx"]?.stringValue)
+        let cy = try SVGProcessor.stringToOptionalCGFloat(xmlElement["cy"]?.stringValue)
+        let r = try SVGProcessor.stringToOptionalCGFloat(xmlElement["r"]?.stringValue)
+        let fx = try SVGProcessor.stringToOptionalCGFloat(xmlElement["fx"]?.stringValue)
+        let fy = try SVGProcessor.stringToOptionalCGFloat(xmlElement["fy"]?.stringValue)
+
+        xmlElement["cx"] = nil
+        xmlElement["cy"] = nil
+        xmlElement["r"] = nil
+        xmlElement["fx"] = nil
+        xmlElement["fy"] = nil
+
+        let gradientUnitString = xmlElement["gradientUnits"]?.stringValue ?? "objectBoundingBox"
+        guard let gradientUnit = SVGGradientUnit(rawValue: gradientUnitString) else {
+            throw Error.invalidSVG(#file, #function, #line)
+        }
+        xmlElement["gradientUnits"] = nil
+
+        let spreadMethod = try processSpreadMethod(xmlElement)
+        let gradientTransform = try processTransform(xmlElement, elementKey: "gradientTransform")
+        let inherited: SVGGradient?
+        if let _ = xmlElement["xlink:href"]?.stringValue {
+            inherited = try processInheritedGradient(xmlElement, elementKey: "xlink:href", state: state)
+        }
+        else {
+            inherited = nil
+        }
+        // Attributes that are not specified are left as .None so that they
+        // can be inherited. The center and radius default to 50%, of the
+        // viewport in userSpaceOnUse units, and the focal point to the
+        // center once inheritance has been resolved.
+        let viewport = state.document?.viewBox ?? state.document?.viewPort
+        return SVGRadialGradient(stops: stops, gradientUnit: gradientUnit, spreadMethod: spreadMethod,
+                                 centerX: cx, centerY: cy, radius: r, focalX: fx, focalY: fy,
+                                 viewport: viewport, transform: gradientTransform, inherited: inherited)
+    }
 }
 
 private protocol Parser {
@@ -986,41 +1360,49 @@ extension SVGProcessor: Parser {
     
     /// Parse the list of points from a polygon/polyline entry
     private class func parseListOfPoints(entry : String) throws -> [CGPoint] {
-        // Split by all commas and whitespace, then group into coords of two floats
-        let entry = entry.stringByTrimmingCharactersInSet(NSCharacterSet.whitespaceAndNewlineCharacterSet())
-        let separating = NSMutableCharacterSet.whitespaceAndNewlineCharacterSet()
-        separating.addCharactersInString(",")
-        let parts = entry.componentsSeparatedByCharactersInSet(separating).filter { !$0.isEmpty }
-        return try floatsToPoints(parts.map({Float($0)!}))
+        guard let numbers = SVGNumberScanner.scan(entry, body: { $0.scanNumberList() }) else {
+            throw Error.corruptXML(#file, #function, #line)
+        }
+        // Points have always been read at Float precision and the output
+        // depends on it.
+        return try floatsToPoints(numbers.map({ Float($0) }))
+    }
+
+    /// Reads a number from the bytes of string. Units are ignored and a
+    /// percentage is divided by 100 when allowed.
+    private class func parseNumber(string: String, allowPercentage: Bool) throws -> CGFloat {
+        return try SVGNumberScanner.scan(string) {
+            (inout scanner: SVGNumberScanner) throws -> CGFloat in
+            scanner.skipWhitespace()
+            guard var value = scanner.scanNumber() else {
+                throw Error.corruptXML(#file, #function, #line)
+            }
+            if allowPercentage && scanner.peek == UInt8(ascii: "%") {
+                scanner.skipByte()
+                value *= 0.01
+            }
+            // This is probably a bit reckless.
+            let trimmed = NSMutableCharacterSet.lowercaseLetterCharacterSet()
+            trimmed.formUnionWithCharacterSet(NSCharacterSet.whitespaceAndNewlineCharacterSet())
+            if !scanner.scanRemainder().stringByTrimmingCharactersInSet(trimmed).isEmpty {
+                throw Error.corruptXML(#file, #function, #line)
+            }
+            return CGFloat(value)
+        }
     }
 
     private class func stringToCGFloat(string: String?) throws -> CGFloat {
         guard let string = string else {
             throw Error.expectedSVGElementNotFound(#file, #function, #line)
         }
-        // This is probably a bit reckless.
-        let string2 = string.stringByTrimmingCharactersInSet(NSCharacterSet.lowercaseLetterCharacterSet())
-        if string2.characters.isEmpty {
-            throw Error.corruptXML(#file, #function, #line)
-        }
-        if string2.characters.last! == Character("%") {
-            return try self.percentageStringToCGFloat(String(string2.characters.dropLast()))
-        }
-        guard let value = NSNumberFormatter().numberFromString(string2) else {
-            throw Error.corruptXML(#file, #function, #line)
-        }
-        return CGFloat(value.doubleValue)
+        return try parseNumber(string, allowPercentage: true)
     }
     
     private class func stringToOptionalCGFloat(string: String?) throws -> CGFloat? {
         guard let string = string else {
             return Optional.None
         }
-        let string2 = string.stringByTrimmingCharactersInSet(NSCharacterSet.lowercaseLetterCharacterSet())
-        guard let value = NSNumberFormatter().numberFromString(string2) else {
-            throw Error.corruptXML(#file, #function, #line)
-        }
-        return CGFloat(value.doubleValue)
+        return try parseNumber(string, allowPercentage: false)
     }
     
     private class func stringToOptionalClampedCGFloat(string: String?, minClamp: CGFloat = -CGFloat.max, maxClamp: CGFloat = CGFloat.max) throws -> CGFloat? {
@@ -1039,18 +1421,6 @@ extension SVGProcessor: Parser {
         }
         return try stringToCGFloat(stringValue)
     }
-    
-    private class func percentageStringToCGFloat(string: String?) throws -> CGFloat {
-        guard let string = string else {
-            throw Error.corruptXML(#file, #function, #line)
-        }
-        
-        let theValue = NSNumberFormatter().numberFromString(string)
-        guard let value = theValue else {
-            throw Error.corruptXML(#file, #function, #line)
-        }
-        return CGFloat(value.doubleValue * 0.01)
-    }
 }
 
 extension SVGProcessor.Event: CustomStringConvertible {
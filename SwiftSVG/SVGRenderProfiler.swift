@@ -0,0 +1,201 @@
+//
+//  SVGRenderProfiler.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+/// Measures what each element costs to render through an SVGRenderer: the
+/// time from its prerender callback to its postrender callback, the path
+/// segments it draws and the bytes the renderer emits for it, if the
+/// renderer is an OutputMeasuringRenderer. The costs of elements instanced
+/// by a use element are counted under the use element.
+///
+///     let profiler = SVGRenderProfiler()
+///     profiler.install(svgRenderer)
+///     try svgRenderer.renderDocument(svgDocument, renderer: renderer)
+///     let report = profiler.foldedStacks(.time)
+public final class SVGRenderProfiler {
+    public enum Metric {
+        /// Microseconds.
+        case time
+        case pathSegments
+        case bytes
+    }
+
+    /// An element rendered in a particular place in the tree. Totals include
+    /// the element's descendants.
+    public final class Node {
+        public let name: String
+        public private(set) var children = [Node]()
+        public private(set) var totalTime: Double = 0.0
+        public private(set) var totalPathSegments = 0
+        public private(set) var totalBytes = 0
+
+        public var selfTime: Double {
+            return totalTime - children.reduce(0.0) { $0 + $1.totalTime }
+        }
+
+        public var selfPathSegments: Int {
+            return totalPathSegments - children.reduce(0) { $0 + $1.totalPathSegments }
+        }
+
+        public var selfBytes: Int {
+            return totalBytes - children.reduce(0) { $0 + $1.totalBytes }
+        }
+
+        init(name: String) {
+            self.name = name
+        }
+
+        private var startTicks: UInt64 = 0
+        private var startBytes = 0
+    }
+
+    /// The document being rendered, whose children are the elements
+    /// rendered at the top level.
+    public private(set) var root = Node(name: "document")
+
+    public init() {
+    }
+
+    /// Starts profiling every render through svgRenderer. Callbacks already
+    /// set on svgRenderer are still called.
+    public func install(svgRenderer: SVGRenderer) {
+        let prerender = svgRenderer.callbacks.prerenderElement
+        let postrender = svgRenderer.callbacks.postrenderElement
+        svgRenderer.callbacks.prerenderElement = {
+            [unowned self] (svgElement: SVGElement, renderer: Renderer) throws -> Bool in
+            if let prerender = prerender {
+                guard try prerender(svgElement: svgElement, renderer: renderer) else {
+                    return false
+                }
+            }
+            self.beginElement(svgElement, renderer: renderer)
+            return true
+        }
+        svgRenderer.callbacks.postrenderElement = {
+            [unowned self] (svgElement: SVGElement, renderer: Renderer) throws -> Void in
+            self.endElement(svgElement, renderer: renderer)
+            try postrender?(svgElement: svgElement, renderer: renderer)
+        }
+    }
+
+    public func reset() {
+        root = Node(name: "document")
+        stack = []
+        pathSegmentCounts = [: ]
+    }
+
+    /// One line per element with a non zero cost, in the folded stack format
+    /// read by flame graph tools: the names from the document down to the
+    /// element separated by semicolons, a space and the element's own cost.
+    /// Elements are named by their id, or by their type when they have none.
+    public func foldedStacks(metric: Metric = .time) -> String {
+        var lines = [String]()
+        func visit(node: Node, stackName: String) {
+            let value: Int
+            switch metric {
+                case .time:
+                    value = Int(node.selfTime * 1.0e6)
+                case .pathSegments:
+                    value = node.selfPathSegments
+                case .bytes:
+                    value = node.selfBytes
+            }
+            if value > 0 {
+                lines.append("\(stackName) \(value)")
+            }
+            for child in node.children {
+                visit(child, stackName: stackName + ";" + child.name)
+            }
+        }
+        visit(root, stackName: root.name)
+        return lines.joinWithSeparator("\n")
+    }
+
+    // MARK: -
+
+    private var stack = [Node]()
+    private var pathSegmentCounts = [ObjectIdentifier: Int]()
+
+    private func beginElement(svgElement: SVGElement, renderer: Renderer) {
+        if var measuringRenderer = renderer as? OutputMeasuringRenderer {
+            measuringRenderer.measuresOutput = true
+        }
+        let node = Node(name: SVGRenderProfiler.nameForElement(svgElement))
+        (stack.last ?? root).children.append(node)
+        node.startBytes = (renderer as? OutputMeasuringRenderer)?.outputByteCount ?? 0
+        stack.append(node)
+        // Started last so the profiler's own work isn't counted.
+        node.startTicks = mach_absolute_time()
+    }
+
+    private func endElement(svgElement: SVGElement, renderer: Renderer) {
+        let endTicks = mach_absolute_time()
+        guard let node = stack.popLast() else {
+            return
+        }
+        node.totalTime = Double(endTicks - node.startTicks) * SVGInstrumentation.secondsPerTick
+        let bytes = (renderer as? OutputMeasuringRenderer)?.outputByteCount ?? 0
+        node.totalBytes = bytes - node.startBytes
+        node.totalPathSegments = node.children.reduce(pathSegmentCount(svgElement)) { $0 + $1.totalPathSegments }
+        if let parent = stack.last {
+            // The parent's clock keeps running while the child is measured.
+            parent.startTicks += mach_absolute_time() - endTicks
+        }
+        else {
+            root.totalTime += node.totalTime
+            root.totalBytes += node.totalBytes
+            root.totalPathSegments += node.totalPathSegments
+        }
+    }
+
+    private func pathSegmentCount(svgElement: SVGElement) -> Int {
+        guard let pathGenerator = svgElement as? PathGenerator else {
+            return 0
+        }
+        if let count = pathSegmentCounts[ObjectIdentifier(svgElement)] {
+            return count
+        }
+        let geometry = (svgElement as? SVGPath)?.source.geometry ?? SVGPathGeometry(path: pathGenerator.cgpath)
+        let count = geometry.verbs.count
+        pathSegmentCounts[ObjectIdentifier(svgElement)] = count
+        return count
+    }
+
+    private static func nameForElement(svgElement: SVGElement) -> String {
+        if let id = svgElement.id where !id.isEmpty {
+            // Semicolons separate frames and a space ends the stack.
+            return id.stringByReplacingOccurrencesOfString(";", withString: "_")
+                .stringByReplacingOccurrencesOfString(" ", withString: "_")
+        }
+        switch svgElement {
+            case is SVGDocument:
+                return "svg"
+            case is SVGUse:
+                return "use"
+            case is SVGSimpleText:
+                return "text"
+            case is SVGPath:
+                return "path"
+            case is SVGLine:
+                return "line"
+            case is SVGPolygon:
+                return "polygon"
+            case is SVGPolyline:
+                return "polyline"
+            case is SVGRect:
+                return "rect"
+            case is SVGEllipse:
+                return "ellipse"
+            case is SVGCircle:
+                return "circle"
+            default:
+                return "g"
+        }
+    }
+}
@@ -20,6 +20,25 @@ public class SVGRenderer {
 
     public var callbacks = Callbacks()
 
+    /// When set text is drawn as outlines from the outliner's fonts rather
+    /// than passed to the renderer as text.
+    public var textOutliner: SVGTextOutliner? = .None
+
+    /// When set strokes of shapes are drawn by filling their outlines from
+    /// the stroker, for renderers that can only fill.
+    public var stroker: SVGStroker? = .None
+
+    /// The device pixels per document unit, which decides how finely the
+    /// stroker outlines curves.
+    public var strokeScale: CGFloat = 1.0
+
+    /// The use elements the element being rendered is being instanced through.
+    private var instanceContext: SVGInstanceContext? = .None
+
+    /// The inherited stroke properties and transform, only kept with a stroker.
+    private var strokeStyle = Style()
+    private var strokeTransform = CGAffineTransformIdentity
+
     public init() {
     }
 
@@ -38,28 +57,36 @@ public class SVGRenderer {
     }
 
     public func renderElement(svgElement: SVGElement, renderer: Renderer) throws {
+        if try renderElementContents(svgElement, renderer: renderer) {
+            try callbacks.postrenderElement?(svgElement: svgElement, renderer: renderer)
+        }
+    }
+
+    /// Returns true if the element was rendered, once the renderer has ended
+    /// the element, so that postrenderElement sees everything it drew.
+    private func renderElementContents(svgElement: SVGElement, renderer: Renderer) throws -> Bool {
         if !svgElement.display {
-            return
+            return false
         }
 
-        let hasStroke = svgElement.hasStroke
+        let hasStroke = svgElement.strokeColorInContext(instanceContext) != nil
         let hasFill: Bool
         let hasGradientFill: Bool
 
-        if let _ = svgElement.gradientFill {
+        if let _ = svgElement.gradientFillInContext(instanceContext) {
             hasGradientFill = true
             hasFill = false
         }
         else {
             hasGradientFill = false
-            hasFill = svgElement.hasFill
+            hasFill = svgElement.fillColorInContext(instanceContext) != nil
         }
 
-        if let _ = svgElement as? SVGContainer {
+        if svgElement is SVGContainer || svgElement is SVGUse {
             renderer.startGroup(svgElement.id)
         }
         else if !(hasStroke || hasFill || hasGradientFill) {
-            return
+            return false
         }
         
         // Because text has an array of text spans for rendering purposes a
@@ -82,17 +109,30 @@ public class SVGRenderer {
         }
         
         if try prerenderElement(svgElement, renderer: renderer) == false {
-            return
+            return false
+        }
+
+        let outerStrokeStyle = strokeStyle
+        let outerStrokeTransform = strokeTransform
+        defer {
+            strokeStyle = outerStrokeStyle
+            strokeTransform = outerStrokeTransform
         }
 
         if !(svgElement is SVGSimpleText) {
             if let style = try styleForElement(svgElement) {
                 renderer.style = style
+                if stroker != nil {
+                    strokeStyle.apply(style)
+                }
             }
         }
 
         if let transform = svgElement.transform {
             renderer.concatTransform(transform.toCGAffineTransform())
+            if stroker != nil {
+                strokeTransform = CGAffineTransformConcat(transform.toCGAffineTransform(), strokeTransform)
+            }
         }
         
         switch svgElement {
@@ -100,39 +140,82 @@ public class SVGRenderer {
                 try renderDocument(svgDocument, renderer: renderer)
             case let svgGroup as SVGGroup:
                 try renderGroup(svgGroup, renderer: renderer)
+            case let svgUse as SVGUse:
+                if let context = instanceContext where context.contains(svgUse) {
+                    SVGLog.warning("Skipping a use element that instances itself")
+                    break
+                }
+                let outerContext = instanceContext
+                instanceContext = SVGInstanceContext(use: svgUse, outer: outerContext)
+                defer {
+                    instanceContext = outerContext
+                }
+                try renderElement(svgUse.referencedElement, renderer: renderer)
             case let pathable as PathGenerator:
                 // svgElement.printSelfAndParents()
-                if (hasGradientFill) {
-                    print("Need to render gradient fill: ")
-                    var gradientFill = svgElement.gradientFill!.coalesceLinearGradientInheritance()
-                    gradientFill.owningElement = svgElement
-                    print("========================================================")
-                    print(gradientFill.description)
-                    // renderer.addPath(pathable)
-                    renderer.drawLinearGradient(gradientFill, pathGenerator: pathable)
-                }
-                if (hasStroke || hasFill) {
+                if hasGradientFill {
+                    if let gradientFill = svgElement.linearGradientFillInContext(instanceContext) {
+                        SVGLog.debug("Rendering gradient fill: \(gradientFill.gradient.description)")
+                        renderer.drawLinearGradient(gradientFill, pathGenerator: pathable)
+                    }
+                    else if let gradientFill = svgElement.radialGradientFillInContext(instanceContext) {
+                        SVGLog.debug("Rendering gradient fill: \(gradientFill.gradient.description)")
+                        renderer.drawRadialGradient(gradientFill, pathGenerator: pathable)
+                    }
+                }
+                if stroker != nil && hasStroke {
+                    if hasFill {
+                        renderer.addPath(pathable)
+                        renderer.drawPath(pathable.evenOdd ? .EOFill : .Fill)
+                    }
+                    renderStrokeOutline(pathable.cgpath, style: strokeStyle, transform: strokeTransform,
+                                        color: svgElement.strokeColorInContext(instanceContext), renderer: renderer)
+                }
+                else if (hasStroke || hasFill) {
                     let evenOdd = hasFill && pathable.evenOdd
                     let mode = CGPathDrawingMode(hasStroke: hasStroke, hasFill: hasFill, evenOdd: evenOdd)
                     renderer.addPath(pathable)
                     renderer.drawPath(mode)
                 }
             case let textElement as SVGSimpleText:
-                for textSpan in textElement.spans {
-                    renderer.pushGraphicsState()
-                    renderer.startElement(nil)
-                    defer {
-                        renderer.restoreGraphicsState()
-                        renderer.endElement()
-                    }
-                    if let transform = textSpan.transform {
-                        renderer.concatCTM(transform.toCGAffineTransform())
-                    }
-                    renderer.drawText(textSpan)
-                }
+                renderTextSpans(textElement, renderer: renderer)
             default:
                 assert(false)
         }
+        return true
+    }
+
+    private func renderTextSpans(textElement: SVGSimpleText, renderer: Renderer) {
+        for textSpan in textElement.spans {
+            renderer.pushGraphicsState()
+            renderer.startElement(nil)
+            defer {
+                renderer.restoreGraphicsState()
+                renderer.endElement()
+            }
+            if let transform = textSpan.transform {
+                renderer.concatCTM(transform.toCGAffineTransform())
+            }
+            if let textOutliner = textOutliner {
+                textOutliner.drawTextSpan(textSpan, renderer: renderer)
+            }
+            else {
+                renderer.drawText(textSpan)
+            }
+        }
+    }
+
+    /// Strokes path with the stroker by filling its outline.
+    private func renderStrokeOutline(path: CGPath, style: Style, transform: CGAffineTransform,
+                                     color: CGColor?, renderer: Renderer) {
+        guard let stroker = stroker else {
+            return
+        }
+        let scale = strokeScale * sqrt(abs(transform.a * transform.d - transform.b * transform.c))
+        let outline = stroker.strokedPath(path, style: SVGStrokeStyle(style: style), scale: scale)
+        renderer.fillColor = color
+        renderer.addPath(SVGOutlinePath(path: outline))
+        renderer.drawPath(.Fill)
     }
 
     public func pathForElement(svgElement: SVGElement) -> CGPath? {
@@ -153,6 +236,8 @@ public class SVGRenderer {
                     }
                 }
                 return path
+            case let svgUse as SVGUse:
+                return pathForElement(svgUse.referencedElement)
             case let pathable as CGPathable:
                 return pathable.cgpath
             case _ as SVGSimpleText:
@@ -162,15 +247,21 @@ public class SVGRenderer {
         }
     }
 
+    /// Geometry built while rendering is attributed to the type of renderer,
+    /// for example "CGContext" or "MovingImagesRenderer".
     public func renderDocument(svgDocument: SVGDocument, renderer: Renderer) throws {
-        if let viewBox = svgDocument.viewBox {
-            renderer.startDocument(viewBox)
-        }
-        renderer.fillColor = try SVGColors.stringToColor("black")
-        renderer.lineWidth = 1.0
+        try SVGInstrumentation.time(.render) {
+            try SVGInstrumentation.attribute(String(renderer.dynamicType)) {
+                if let viewBox = svgDocument.viewBox {
+                    renderer.startDocument(viewBox)
+                }
+                renderer.fillColor = try SVGColors.stringToColor("black")
+                renderer.lineWidth = 1.0
 
-        for child in svgDocument.children {
-            try renderElement(child, renderer: renderer)
+                for child in svgDocument.children {
+                    try self.renderElement(child, renderer: renderer)
+                }
+            }
         }
     }
 
@@ -179,4 +270,162 @@ public class SVGRenderer {
             try renderElement(child, renderer: renderer)
         }
     }
-}
\ No newline at end of file
+}
+// MARK: -
+
+/// What a node of a compact document inherits from the nodes it's drawn
+/// inside, resolved on the way down as compact nodes have no parent objects.
+private struct SVGCompactInheritance {
+    var fillColor: CGColor?
+    var strokeColor: CGColor?
+    var strokeStyle = Style()
+    var strokeTransform = CGAffineTransformIdentity
+    /// The use nodes being drawn through, innermost last.
+    var uses = [Int]()
+}
+
+/// A path of a compact document as renderers take paths. Only path elements
+/// keep their path data, so for other shapes it's made from the CGPath when
+/// a renderer asks for it.
+private final class SVGCompactPath: PathGenerator {
+    let cgpath: CGPath
+    lazy var svgpath: String? = SVGPathGeometry(path: self.cgpath).svgPath
+    var mipath: MovingImagesPath? { get { return .None } }
+    var evenOdd: Bool
+
+    init(path: CGPath, svgPath: String?, evenOdd: Bool) {
+        self.cgpath = path
+        self.evenOdd = evenOdd
+        if let svgPath = svgPath {
+            self.svgpath = svgPath
+        }
+    }
+}
+
+public extension SVGRenderer {
+    /// Renders a compact document the way renderDocument renders the
+    /// document it was made from. The callbacks take elements so aren't
+    /// called.
+    func renderCompactDocument(compactDocument: SVGCompactDocument, renderer: Renderer) throws {
+        try SVGInstrumentation.time(.render) {
+            try SVGInstrumentation.attribute(String(renderer.dynamicType)) {
+                if let viewBox = compactDocument.viewBox {
+                    renderer.startDocument(viewBox)
+                }
+                var inherited = SVGCompactInheritance()
+                inherited.fillColor = try SVGColors.stringToColor("black")
+                renderer.fillColor = inherited.fillColor
+                renderer.lineWidth = 1.0
+
+                for child in compactDocument.childIndices(compactDocument.rootIndex) {
+                    self.renderCompactNode(child, compactDocument: compactDocument, renderer: renderer,
+                                           inherited: inherited)
+                }
+            }
+        }
+    }
+
+    private func renderCompactNode(index: Int, compactDocument: SVGCompactDocument, renderer: Renderer,
+                                   inherited: SVGCompactInheritance) {
+        let node = compactDocument.nodes[index]
+        if !node.flags.contains(.display) {
+            return
+        }
+
+        let style: Style? = node.style < 0 ? .None : compactDocument.styles[Int(node.style)]
+        var state = inherited
+        state.fillColor = node.flags.contains(.drawFill) ? style?.fillColor ?? inherited.fillColor : .None
+        state.strokeColor = style?.strokeColor ?? inherited.strokeColor
+
+        let linearGradientFill = compactDocument.linearGradientFills[Int32(index)]
+        let radialGradientFill = compactDocument.radialGradientFills[Int32(index)]
+        let hasGradientFill = linearGradientFill != nil || radialGradientFill != nil
+        let hasFill = !hasGradientFill && state.fillColor != nil
+        let hasStroke = state.strokeColor != nil
+
+        let id = compactDocument.id(index)
+        switch node.kind {
+            case .document, .group, .use:
+                renderer.startGroup(id)
+            case .text:
+                if !(hasStroke || hasFill || hasGradientFill) {
+                    return
+                }
+                renderer.startGroup(id)
+            default:
+                if !(hasStroke || hasFill || hasGradientFill) {
+                    return
+                }
+                renderer.startElement(id)
+        }
+        defer {
+            renderer.endElement()
+        }
+
+        renderer.pushGraphicsState()
+        defer {
+            renderer.restoreGraphicsState()
+        }
+
+        if let style = style where node.kind != .text {
+            renderer.style = style
+            if stroker != nil {
+                state.strokeStyle.apply(style)
+            }
+        }
+        if node.transform >= 0 {
+            let transform = compactDocument.transforms[Int(node.transform)]
+            renderer.concatTransform(transform)
+            if stroker != nil {
+                state.strokeTransform = CGAffineTransformConcat(transform, state.strokeTransform)
+            }
+        }
+
+        switch node.kind {
+            case .document, .group:
+                for child in compactDocument.childIndices(index) {
+                    renderCompactNode(child, compactDocument: compactDocument, renderer: renderer, inherited: state)
+                }
+            case .use:
+                if state.uses.contains(index) {
+                    SVGLog.warning("Skipping a use element that instances itself")
+                    break
+                }
+                state.uses.append(index)
+                if node.content >= 0 {
+                    renderCompactNode(Int(node.content), compactDocument: compactDocument, renderer: renderer,
+                                      inherited: state)
+                }
+            case .text:
+                if let textElement = compactDocument.texts[Int32(index)] {
+                    renderTextSpans(textElement, renderer: renderer)
+                }
+            default:
+                guard node.content >= 0 else {
+                    break
+                }
+                let path = SVGCompactPath(path: compactDocument.paths[Int(node.content)],
+                                          svgPath: compactDocument.pathData[node.content],
+                                          evenOdd: node.flags.contains(.evenOdd))
+                if let gradientFill = linearGradientFill {
+                    renderer.drawLinearGradient(gradientFill, pathGenerator: path)
+                }
+                else if let gradientFill = radialGradientFill {
+                    renderer.drawRadialGradient(gradientFill, pathGenerator: path)
+                }
+                if stroker != nil && hasStroke {
+                    if hasFill {
+                        renderer.addPath(path)
+                        renderer.drawPath(path.evenOdd ? .EOFill : .Fill)
+                    }
+                    renderStrokeOutline(path.cgpath, style: state.strokeStyle, transform: state.strokeTransform,
+                                        color: state.strokeColor, renderer: renderer)
+                }
+                else if hasStroke || hasFill {
+                    let evenOdd = hasFill && path.evenOdd
+                    renderer.addPath(path)
+                    renderer.drawPath(CGPathDrawingMode(hasStroke: hasStroke, hasFill: hasFill, evenOdd: evenOdd))
+                }
+        }
+    }
+}
@@ -0,0 +1,171 @@
+//
+//  SVGStroker.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+import SwiftGraphics
+
+/// The properties that decide the outline of a stroke.
+public struct SVGStrokeStyle: Hashable {
+    public var lineWidth: CGFloat = 1.0
+    public var lineCap = CGLineCap.Butt
+    public var lineJoin = CGLineJoin.Miter
+    /// CoreGraphics' default rather than SVG's, to match what the other
+    /// renderers draw when no miter limit is set.
+    public var miterLimit: CGFloat = 10.0
+    public var lineDash = [CGFloat]()
+    public var lineDashPhase: CGFloat = 0.0
+
+    public init() {
+    }
+
+    /// The stroke style with the properties style sets.
+    public init(style: Style) {
+        lineWidth = style.lineWidth ?? lineWidth
+        lineCap = style.lineCap ?? lineCap
+        lineJoin = style.lineJoin ?? lineJoin
+        miterLimit = style.miterLimit ?? miterLimit
+        lineDash = style.lineDash ?? lineDash
+        lineDashPhase = style.lineDashPhase ?? lineDashPhase
+    }
+
+    public var hashValue: Int {
+        return lineWidth.hashValue ^ Int(lineCap.rawValue) << 8 ^ Int(lineJoin.rawValue) << 12 ^
+            miterLimit.hashValue ^ lineDash.count << 16 ^ lineDashPhase.hashValue
+    }
+}
+
+public func == (lhs: SVGStrokeStyle, rhs: SVGStrokeStyle) -> Bool {
+    return lhs.lineWidth == rhs.lineWidth && lhs.lineCap == rhs.lineCap && lhs.lineJoin == rhs.lineJoin &&
+        lhs.miterLimit == rhs.miterLimit && lhs.lineDash == rhs.lineDash && lhs.lineDashPhase == rhs.lineDashPhase
+}
+
+/// Turns strokes into the outlines that filling draws the same as the
+/// stroke, with its joins, caps, miter limit and dash pattern, for renderers
+/// that can only fill. The outlines are made by CoreGraphics, with
+/// CGPathCreateCopyByDashingPath and CGPathCreateCopyByStrokingPath, so the
+/// stroker only runs where CoreGraphics does. The outlines it makes can be
+/// filled by any renderer.
+///
+/// Outlines are cached by the identity of the path, the stroke style and
+/// the scale. Path elements with the same path data share one CGPath, so
+/// the same geometry stroked the same way many times, like the roads of a
+/// map, is only outlined once. The scale is the device pixels per unit the
+/// outline will be drawn at, and decides how closely the outline's curves
+/// follow the stroke. The stroker is thread safe.
+public final class SVGStroker {
+    /// Outlines are forgotten once there are this many.
+    public var maximumCount = 4096
+
+    public private(set) var hitCount = 0
+    public private(set) var missCount = 0
+
+    public init() {
+    }
+
+    /// The outline of path stroked with style, filled with the non-zero
+    /// winding rule.
+    public func strokedPath(path: CGPath, style: SVGStrokeStyle, scale: CGFloat = 1.0) -> CGPath {
+        let key = StrokeKey(path: ObjectIdentifier(path), style: style, scale: scale)
+
+        lock.lock()
+        if let entry = outlines[key] where entry.path === path {
+            hitCount += 1
+            lock.unlock()
+            return entry.outline
+        }
+        missCount += 1
+        lock.unlock()
+
+        let outline = SVGStroker.outline(path, style: style, scale: scale)
+        lock.lock()
+        if outlines.count >= maximumCount {
+            outlines.removeAll(keepCapacity: true)
+        }
+        outlines[key] = StrokeEntry(path: path, outline: outline)
+        lock.unlock()
+        return outline
+    }
+
+    public var count: Int {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        return outlines.count
+    }
+
+    public func removeAll() {
+        lock.lock()
+        outlines.removeAll()
+        hitCount = 0
+        missCount = 0
+        lock.unlock()
+    }
+
+    // MARK: -
+
+    private let lock = NSLock()
+    private var outlines = [StrokeKey: StrokeEntry]()
+
+    // The path is stroked at device scale so the curve approximations are
+    // fine enough there, then scaled back.
+    private static func outline(path: CGPath, style: SVGStrokeStyle, scale: CGFloat) -> CGPath {
+        let scale = scale > 0.0 ? scale : 1.0
+        var toDevice = CGAffineTransformMakeScale(scale, scale)
+        var fromDevice = CGAffineTransformMakeScale(1.0 / scale, 1.0 / scale)
+        guard var devicePath = CGPathCreateCopyByTransformingPath(path, &toDevice) else {
+            return CGPathCreateMutable()
+        }
+
+        // A dash pattern that is all zeros or has a negative length is
+        // ignored, and one with an odd number of lengths is repeated.
+        var lineDash = style.lineDash
+        if lineDash.contains({ $0 < 0.0 }) || !lineDash.contains({ $0 > 0.0 }) {
+            lineDash = []
+        }
+        else if lineDash.count % 2 == 1 {
+            lineDash += lineDash
+        }
+        if !lineDash.isEmpty {
+            let deviceDash = lineDash.map() { $0 * scale }
+            if let dashedPath = CGPathCreateCopyByDashingPath(devicePath, nil, style.lineDashPhase * scale,
+                                                              deviceDash, deviceDash.count) {
+                devicePath = dashedPath
+            }
+        }
+
+        guard let deviceOutline = CGPathCreateCopyByStrokingPath(devicePath, nil, style.lineWidth * scale,
+                                                                 style.lineCap, style.lineJoin, style.miterLimit),
+            let outline = CGPathCreateCopyByTransformingPath(deviceOutline, &fromDevice) else {
+            return CGPathCreateMutable()
+        }
+        return outline
+    }
+}
+
+private struct StrokeKey: Hashable {
+    let path: ObjectIdentifier
+    let style: SVGStrokeStyle
+    let scale: CGFloat
+
+    var hashValue: Int {
+        return path.hashValue ^ style.hashValue ^ scale.hashValue
+    }
+}
+
+private func == (lhs: StrokeKey, rhs: StrokeKey) -> Bool {
+    return lhs.path == rhs.path && lhs.scale == rhs.scale && lhs.style == rhs.style
+}
+
+private struct StrokeEntry {
+    /// Kept so the path's address isn't reused by another path while its
+    /// outline is cached.
+    let path: CGPath
+    let outline: CGPath
+}
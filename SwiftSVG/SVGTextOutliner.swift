@@ -0,0 +1,298 @@
+//
+//  SVGTextOutliner.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+import SwiftGraphics
+
+/// Converts text to outlines using fonts loaded from local font files, so
+/// text renders the same wherever the files are, whatever fonts are
+/// installed, and through renderers that can only draw paths.
+///
+/// The outline of each glyph is kept in font units as an SVGPathGeometry the
+/// first time the glyph is used, and the glyphs and positions CoreText
+/// shapes a string into are kept per string, font and size, so a label
+/// repeated across a map is only shaped once. Characters none of the fonts
+/// have are outlined from the font CoreText substitutes for them, with a
+/// warning the first time each substitute is used. The outliner is thread
+/// safe.
+///
+/// Fonts are read, shaped and outlined with CoreText and CoreGraphics, so
+/// the outliner only runs where those frameworks do, although the outlines
+/// it produces can be drawn by any renderer.
+public final class SVGTextOutliner {
+    public enum Error: ErrorType {
+        case invalidFontFile(NSURL)
+        case noFonts
+    }
+
+    /// The PostScript names of the loaded fonts, the first being the font
+    /// for text whose families match none of them.
+    public let postscriptNames: [String]
+
+    public init(fontURLs: [NSURL]) throws {
+        var fonts = [OutlineFont]()
+        for url in fontURLs {
+            guard let provider = CGDataProviderCreateWithURL(url), let cgFont = CGFontCreateWithDataProvider(provider) else {
+                throw Error.invalidFontFile(url)
+            }
+            fonts.append(OutlineFont(cgFont: cgFont))
+        }
+        guard !fonts.isEmpty else {
+            throw Error.noFonts
+        }
+        self.fonts = fonts
+        self.postscriptNames = fonts.map() { $0.postscriptName }
+    }
+
+    public convenience init(fontURL: NSURL) throws {
+        try self.init(fontURLs: [fontURL])
+    }
+
+    /// The outline of string set at size with its baseline starting at
+    /// origin, in the y down space of the document.
+    public func geometry(string: String, fontFamily: String, size: CGFloat, origin: CGPoint) -> SVGPathGeometry {
+        let run = shapedRun(string, fontIndex: indexOfFont(fontFamily), size: size)
+
+        var verbs = [SVGPathGeometry.Verb]()
+        var points = [CGPoint]()
+        for shapedGlyph in run.glyphs {
+            let scale = size / outlineFont(shapedGlyph.fontIndex).unitsPerEm
+            let outline = glyphOutline(shapedGlyph.glyph, fontIndex: shapedGlyph.fontIndex)
+            let x = origin.x + shapedGlyph.position.x
+            let y = origin.y - shapedGlyph.position.y
+            verbs.appendContentsOf(outline.verbs)
+            // Glyphs are drawn y up.
+            points.appendContentsOf(outline.points.map() {
+                CGPoint(x: x + $0.x * scale, y: y - $0.y * scale)
+            })
+        }
+        return SVGPathGeometry(verbs: verbs, points: points)
+    }
+
+    /// The typographic width of string set at size.
+    public func width(string: String, fontFamily: String, size: CGFloat) -> CGFloat {
+        return shapedRun(string, fontIndex: indexOfFont(fontFamily), size: size).width
+    }
+
+    /// The outline of a text span, positioned for its text anchor.
+    public func pathGenerator(textSpan: SVGTextSpan) -> PathGenerator {
+        let string = textSpan.string as String
+        var origin = textSpan.localOrigin
+        if let textAnchor = textSpan.textAnchor where textAnchor != .start {
+            let width = self.width(string, fontFamily: textSpan.fontFamily, size: textSpan.fontSize)
+            origin.x -= textAnchor == .middle ? width / 2 : width
+        }
+        return SVGOutlinePath(geometry: geometry(string, fontFamily: textSpan.fontFamily,
+                                                size: textSpan.fontSize, origin: origin))
+    }
+
+    /// Draws the outline of a text span with its fill and stroke.
+    public func drawTextSpan(textSpan: SVGTextSpan, renderer: Renderer) {
+        let fillColor = textSpan.fillColor
+        let strokeColor = textSpan.strokeColor
+        guard fillColor != nil || strokeColor != nil else {
+            return
+        }
+        renderer.fillColor = fillColor
+        renderer.strokeColor = strokeColor
+        if let strokeWidth = textSpan.strokeWidth {
+            // Negative stroke widths mean fill and stroke to CoreText.
+            renderer.lineWidth = abs(strokeWidth)
+        }
+        renderer.addPath(pathGenerator(textSpan))
+        renderer.drawPath(CGPathDrawingMode(hasStroke: strokeColor != nil, hasFill: fillColor != nil, evenOdd: false))
+    }
+
+    public var glyphOutlineCount: Int {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        return glyphOutlines.count
+    }
+
+    public var shapedRunCount: Int {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        return shapedRuns.count
+    }
+
+    // MARK: -
+
+    private struct ShapedGlyph {
+        let glyph: CGGlyph
+        /// The loaded font or substitute font the glyph is from.
+        let fontIndex: Int
+        let position: CGPoint
+    }
+
+    private struct ShapedRun {
+        let glyphs: [ShapedGlyph]
+        let width: CGFloat
+    }
+
+    private let fonts: [OutlineFont]
+    /// Fonts CoreText substituted for characters the loaded fonts don't
+    /// have, indexed after the loaded fonts.
+    private var substituteFonts = [OutlineFont]()
+    private let lock = NSLock()
+    private var glyphOutlines = [GlyphKey: SVGPathGeometry]()
+    private var shapedRuns = [RunKey: ShapedRun]()
+
+    /// The first loaded font named in the family list, by family or
+    /// PostScript name.
+    private func indexOfFont(fontFamily: String) -> Int {
+        for family in fontFamily.componentsSeparatedByString(",") {
+            let name = family.stringByTrimmingCharactersInSet(NSCharacterSet(charactersInString: " \"'"))
+            if let index = fonts.indexOf({ $0.familyName == name || $0.postscriptName == name }) {
+                return index
+            }
+        }
+        return 0
+    }
+
+    private func outlineFont(fontIndex: Int) -> OutlineFont {
+        if fontIndex < fonts.count {
+            return fonts[fontIndex]
+        }
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        return substituteFonts[fontIndex - fonts.count]
+    }
+
+    /// The index of the substitute font CoreText shaped a run with in place
+    /// of font.
+    private func indexOfSubstituteFont(ctFont: CTFont, postscriptName: String, substitutingFor font: OutlineFont) -> Int {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        if let index = substituteFonts.indexOf({ $0.postscriptName == postscriptName }) {
+            return fonts.count + index
+        }
+        SVGLog.warning("Outlining characters \(font.postscriptName) doesn't have with \(postscriptName)")
+        substituteFonts.append(OutlineFont(cgFont: CTFontCopyGraphicsFont(ctFont, nil)))
+        return fonts.count + substituteFonts.count - 1
+    }
+
+    private func glyphOutline(glyph: CGGlyph, fontIndex: Int) -> SVGPathGeometry {
+        let key = GlyphKey(fontIndex: fontIndex, glyph: glyph)
+        lock.lock()
+        let cachedOutline = glyphOutlines[key]
+        lock.unlock()
+        if let outline = cachedOutline {
+            return outline
+        }
+
+        let outline: SVGPathGeometry
+        if let path = CTFontCreatePathForGlyph(outlineFont(fontIndex).unitFont, glyph, nil) {
+            outline = SVGPathGeometry(path: path)
+        }
+        else {
+            // Spaces have no outline.
+            outline = SVGPathGeometry(verbs: [], points: [])
+        }
+        lock.lock()
+        glyphOutlines[key] = outline
+        lock.unlock()
+        return outline
+    }
+
+    private func shapedRun(string: String, fontIndex: Int, size: CGFloat) -> ShapedRun {
+        let key = RunKey(string: string, fontIndex: fontIndex, size: size)
+        lock.lock()
+        let cachedRun = shapedRuns[key]
+        lock.unlock()
+        if let run = cachedRun {
+            return run
+        }
+
+        let font = fonts[fontIndex]
+        let ctFont = CTFontCreateCopyWithAttributes(font.unitFont, size, nil, nil)
+        let attributes: [NSString : AnyObject] = [ kCTFontAttributeName : ctFont ]
+        let line = CTLineCreateWithAttributedString(CFAttributedStringCreate(kCFAllocatorDefault, string, attributes))
+        var glyphs = [ShapedGlyph]()
+        for runObject in CTLineGetGlyphRuns(line) as NSArray {
+            let ctRun = runObject as! CTRun
+            // Characters the font doesn't have are shaped with a substitute
+            // font, whose glyph numbers mean nothing in this one.
+            var runFontIndex = fontIndex
+            let runAttributes = CTRunGetAttributes(ctRun) as NSDictionary
+            if let runFont = runAttributes[kCTFontAttributeName as NSString] {
+                let runPostscriptName = CTFontCopyPostScriptName(runFont as! CTFont) as String
+                if runPostscriptName != font.postscriptName {
+                    runFontIndex = indexOfSubstituteFont(runFont as! CTFont, postscriptName: runPostscriptName,
+                                                         substitutingFor: font)
+                }
+            }
+            let count = CTRunGetGlyphCount(ctRun)
+            var runGlyphs = [CGGlyph](count: count, repeatedValue: 0)
+            var positions = [CGPoint](count: count, repeatedValue: CGPoint.zero)
+            CTRunGetGlyphs(ctRun, CFRangeMake(0, 0), &runGlyphs)
+            CTRunGetPositions(ctRun, CFRangeMake(0, 0), &positions)
+            for index in 0..<count {
+                glyphs.append(ShapedGlyph(glyph: runGlyphs[index], fontIndex: runFontIndex, position: positions[index]))
+            }
+        }
+        let width = CTLineGetBoundsWithOptions(line, CTLineBoundsOptions(rawValue: 0)).width
+        let run = ShapedRun(glyphs: glyphs, width: width)
+        lock.lock()
+        shapedRuns[key] = run
+        lock.unlock()
+        return run
+    }
+}
+
+// MARK: -
+
+private final class OutlineFont {
+    let postscriptName: String
+    let familyName: String
+    let unitsPerEm: CGFloat
+    /// The font at one unit per font unit, so outlines are in font units.
+    let unitFont: CTFont
+
+    init(cgFont: CGFont) {
+        unitsPerEm = CGFloat(CGFontGetUnitsPerEm(cgFont))
+        unitFont = CTFontCreateWithGraphicsFont(cgFont, unitsPerEm, nil, nil)
+        postscriptName = CTFontCopyPostScriptName(unitFont) as String
+        familyName = CTFontCopyFamilyName(unitFont) as String
+    }
+}
+
+private struct GlyphKey: Hashable {
+    let fontIndex: Int
+    let glyph: CGGlyph
+
+    var hashValue: Int {
+        return fontIndex << 16 ^ Int(glyph)
+    }
+}
+
+private func == (lhs: GlyphKey, rhs: GlyphKey) -> Bool {
+    return lhs.glyph == rhs.glyph && lhs.fontIndex == rhs.fontIndex
+}
+
+private struct RunKey: Hashable {
+    let string: String
+    let fontIndex: Int
+    let size: CGFloat
+
+    var hashValue: Int {
+        return string.hashValue ^ size.hashValue ^ fontIndex
+    }
+}
+
+private func == (lhs: RunKey, rhs: RunKey) -> Bool {
+    return lhs.fontIndex == rhs.fontIndex && lhs.size == rhs.size && lhs.string == rhs.string
+}
@@ -0,0 +1,291 @@
+//
+//  SVGTileExporter.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import CoreServices
+import Foundation
+import ImageIO
+
+/// Exports a document as a pyramid of PNG tiles in the XYZ layout used by
+/// web maps, written as zoom/column/row.png under a directory.
+///
+/// At zoom 0 the document's viewBox fits a single tile, and each zoom level
+/// doubles the scale. Columns count from the left of the viewBox and rows
+/// down from its top. Only the tiles the viewBox covers are rendered.
+///
+/// The document is frozen and its elements indexed once by their bounds, and
+/// each tile only renders the elements the index finds in it. Tiles that no
+/// element touches, or that render nothing, are not written. Tiles from all
+/// the zoom levels are rendered concurrently through bitmap contexts.
+public final class SVGTileExporter {
+    public enum Error: ErrorType {
+        case couldNotWriteTile(NSURL)
+    }
+
+    public struct Report: CustomStringConvertible {
+        /// All the tiles covering the viewBox at each zoom level.
+        public var tileCount = 0
+        public var writtenTileCount = 0
+        public var emptyTileCount = 0
+        public var seconds = 0.0
+
+        public var tilesPerSecond: Double {
+            return seconds > 0.0 ? Double(tileCount) / seconds : 0.0
+        }
+
+        public var description: String {
+            return "\(tileCount) tiles, \(writtenTileCount) written, \(emptyTileCount) empty, " +
+                String(format: "%.3f seconds, %.1f tiles/sec", seconds, tilesPerSecond)
+        }
+    }
+
+    /// The width and height of a tile in pixels.
+    public var tileSize = 256
+
+    /// The number of worker threads pulling tiles off the shared tile queue.
+    public var threadCount = NSProcessInfo.processInfo().activeProcessorCount
+
+    public let frozenDocument: SVGFrozenDocument
+
+    public init(frozenDocument: SVGFrozenDocument) {
+        self.frozenDocument = frozenDocument
+        self.spatialIndex = SVGSpatialIndex(bounds: frozenDocument.elementBounds)
+    }
+
+    public convenience init(svgDocument: SVGDocument) throws {
+        self.init(frozenDocument: try svgDocument.freeze())
+    }
+
+    /// The number of columns and rows of tiles covering the viewBox at zoom.
+    public func tileCount(zoom zoom: Int) -> (columns: Int, rows: Int) {
+        let viewBox = self.viewBox
+        let scale = self.scale(zoom)
+        let tileSize = CGFloat(self.tileSize)
+        let columns = max(1, Int(ceil(viewBox.width * scale / tileSize - 1.0e-6)))
+        let rows = max(1, Int(ceil(viewBox.height * scale / tileSize - 1.0e-6)))
+        return (columns: columns, rows: rows)
+    }
+
+    /// The transform from the document to the bitmap of a tile, with its
+    /// origin at the bottom left.
+    public func transform(zoom zoom: Int, column: Int, row: Int) -> CGAffineTransform {
+        let viewBox = self.viewBox
+        let scale = self.scale(zoom)
+        let tileSize = CGFloat(self.tileSize)
+        var transform = CGAffineTransformMakeTranslation(-CGFloat(column) * tileSize, CGFloat(row + 1) * tileSize)
+        transform = CGAffineTransformScale(transform, scale, -scale)
+        return CGAffineTransformTranslate(transform, -viewBox.origin.x, -viewBox.origin.y)
+    }
+
+    /// Renders and writes the tiles of the zoom levels in zoomLevels. Tiles
+    /// already in directory are replaced.
+    public func exportTiles(zoomLevels: Range<Int>, directory: NSURL) throws -> Report {
+        let startTime = CFAbsoluteTimeGetCurrent()
+        var tiles = [(zoom: Int, column: Int, row: Int)]()
+        for zoom in zoomLevels {
+            let (columns, rows) = tileCount(zoom: zoom)
+            for column in 0..<columns {
+                for row in 0..<rows {
+                    tiles.append((zoom: zoom, column: column, row: row))
+                }
+            }
+        }
+        var report = Report()
+        report.tileCount = tiles.count
+
+        let nextTile = UnsafeMutablePointer<Int32>.alloc(1)
+        nextTile.initialize(-1)
+        defer {
+            nextTile.dealloc(1)
+        }
+        let resultLock = NSLock()
+        var exportError: ErrorType? = .None
+
+        let queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0)
+        dispatch_apply(max(1, threadCount), queue) { _ in
+            while true {
+                let tileIndex = Int(OSAtomicIncrement32(nextTile))
+                if tileIndex >= tiles.count {
+                    break
+                }
+                let tile = tiles[tileIndex]
+                do {
+                    let written = try self.exportTile(tile.zoom, column: tile.column, row: tile.row,
+                                                      directory: directory)
+                    resultLock.lock()
+                    if written {
+                        report.writtenTileCount += 1
+                    }
+                    else {
+                        report.emptyTileCount += 1
+                    }
+                    resultLock.unlock()
+                }
+                catch let error {
+                    resultLock.lock()
+                    exportError = exportError ?? error
+                    resultLock.unlock()
+                }
+            }
+        }
+
+        if let error = exportError {
+            throw error
+        }
+        report.seconds = CFAbsoluteTimeGetCurrent() - startTime
+        return report
+    }
+
+    // MARK: -
+
+    private let spatialIndex: SVGSpatialIndex
+
+    private var viewBox: CGRect {
+        if let viewBox = frozenDocument.viewBox where viewBox.width > 0.0 && viewBox.height > 0.0 {
+            return viewBox
+        }
+        return spatialIndex.extent.isNull ? CGRect(x: 0.0, y: 0.0, width: 1.0, height: 1.0) : spatialIndex.extent
+    }
+
+    /// Pixels per document unit at zoom.
+    private func scale(zoom: Int) -> CGFloat {
+        let viewBox = self.viewBox
+        return CGFloat(tileSize) * pow(2.0, CGFloat(zoom)) / max(viewBox.width, viewBox.height)
+    }
+
+    /// Returns false if the tile is empty and wasn't written.
+    private func exportTile(zoom: Int, column: Int, row: Int, directory: NSURL) throws -> Bool {
+        let transform = self.transform(zoom: zoom, column: column, row: row)
+        // Outset by a pixel for antialiasing.
+        let pixel = 1.0 / scale(zoom)
+        let tileRect = CGRect(x: 0.0, y: 0.0, width: CGFloat(tileSize), height: CGFloat(tileSize))
+        let documentRect = CGRectInset(CGRectApplyAffineTransform(tileRect, CGAffineTransformInvert(transform)),
+                                       -pixel, -pixel)
+        let elements = spatialIndex.elementsIntersecting(documentRect)
+        if elements.isEmpty {
+            return false
+        }
+
+        guard let context = SVGTiledRenderer.makeBitmapContext(tileSize, height: tileSize) else {
+            return false
+        }
+        CGContextConcatCTM(context, transform)
+        try frozenDocument.render(context) { elements.contains($0) }
+        if SVGTileExporter.isTransparent(context) {
+            return false
+        }
+
+        let columnDirectory = directory.URLByAppendingPathComponent("\(zoom)/\(column)", isDirectory: true)
+        try NSFileManager.defaultManager().createDirectoryAtURL(columnDirectory, withIntermediateDirectories: true,
+                                                                attributes: nil)
+        let url = columnDirectory.URLByAppendingPathComponent("\(row).png")
+        guard let image = CGBitmapContextCreateImage(context),
+            let destination = CGImageDestinationCreateWithURL(url, kUTTypePNG, 1, nil) else {
+            throw Error.couldNotWriteTile(url)
+        }
+        CGImageDestinationAddImage(destination, image, nil)
+        guard CGImageDestinationFinalize(destination) else {
+            throw Error.couldNotWriteTile(url)
+        }
+        return true
+    }
+
+    private static func isTransparent(context: CGContext) -> Bool {
+        let bytes = UnsafePointer<UInt8>(CGBitmapContextGetData(context))
+        let bytesPerRow = CGBitmapContextGetBytesPerRow(context)
+        let width = CGBitmapContextGetWidth(context)
+        for y in 0..<CGBitmapContextGetHeight(context) {
+            let row = bytes.advancedBy(y * bytesPerRow)
+            // Alpha is last.
+            for x in 0..<width where row[x * 4 + 3] != 0 {
+                return false
+            }
+        }
+        return true
+    }
+}
+
+// MARK: -
+
+/// A uniform grid over the bounds of a document's elements for finding the
+/// elements in a rectangle. Elements covering more than a quarter of the
+/// grid, like the groups near the top of the tree, are kept in a list and
+/// tested directly rather than put in most of the cells.
+internal struct SVGSpatialIndex {
+    /// The union of the finite bounds.
+    let extent: CGRect
+
+    init(bounds: [CGRect], cellsPerSide: Int = 64) {
+        self.bounds = bounds
+        self.cellsPerSide = cellsPerSide
+        extent = bounds.reduce(CGRect.null) { $1.isNull || $1.isInfinite ? $0 : $0.union($1) }
+        cells = [[Int]](count: cellsPerSide * cellsPerSide, repeatedValue: [])
+        for (index, elementBounds) in bounds.enumerate() {
+            if elementBounds.isNull {
+                continue
+            }
+            if elementBounds.isInfinite {
+                unbounded.append(index)
+                continue
+            }
+            guard let range = cellRange(elementBounds) else {
+                continue
+            }
+            if (range.maxColumn - range.minColumn + 1) * (range.maxRow - range.minRow + 1) > cells.count / 4 {
+                large.append(index)
+                continue
+            }
+            for row in range.minRow...range.maxRow {
+                for column in range.minColumn...range.maxColumn {
+                    cells[row * cellsPerSide + column].append(index)
+                }
+            }
+        }
+    }
+
+    /// The elements whose bounds intersect rect. Elements with infinite
+    /// bounds intersect everything.
+    func elementsIntersecting(rect: CGRect) -> Set<Int> {
+        var elements = Set(unbounded)
+        for index in large where bounds[index].intersects(rect) {
+            elements.insert(index)
+        }
+        guard let range = cellRange(rect) else {
+            return elements
+        }
+        for row in range.minRow...range.maxRow {
+            for column in range.minColumn...range.maxColumn {
+                for index in cells[row * cellsPerSide + column] where bounds[index].intersects(rect) {
+                    elements.insert(index)
+                }
+            }
+        }
+        return elements
+    }
+
+    private let bounds: [CGRect]
+    private let cellsPerSide: Int
+    private var cells: [[Int]]
+    private var unbounded = [Int]()
+    private var large = [Int]()
+
+    private func cellRange(rect: CGRect) -> (minColumn: Int, maxColumn: Int, minRow: Int, maxRow: Int)? {
+        let clipped = rect.intersect(extent)
+        if clipped.isNull {
+            return .None
+        }
+        let cellWidth = max(extent.width, 1.0e-6) / CGFloat(cellsPerSide)
+        let cellHeight = max(extent.height, 1.0e-6) / CGFloat(cellsPerSide)
+        func cell(offset: CGFloat, size: CGFloat) -> Int {
+            return max(0, min(cellsPerSide - 1, Int(floor(offset / size))))
+        }
+        return (minColumn: cell(clipped.minX - extent.minX, size: cellWidth),
+                maxColumn: cell(clipped.maxX - extent.minX, size: cellWidth),
+                minRow: cell(clipped.minY - extent.minY, size: cellHeight),
+                maxRow: cell(clipped.maxY - extent.minY, size: cellHeight))
+    }
+}
@@ -0,0 +1,231 @@
+//
+//  SVGTiledRenderer.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+import SwiftGraphics
+
+/// Renders an SVGDocument into a bitmap by splitting the output into tiles
+/// and rasterizing the tiles concurrently.
+///
+/// The document is frozen first, so the tiles all render the same immutable
+/// snapshot and never touch the document's elements. Each element is binned
+/// into the tiles its device space bounds overlap, and a tile only renders
+/// the elements in its bin. Every tile renders straight into its own region
+/// of the final bitmap through a bitmap context that shares the final
+/// bitmap's memory, so there is no separate stitching copy. Tiles are
+/// aligned to whole device pixels which keeps the output pixel identical to
+/// rendering the whole document on a single thread.
+public class SVGTiledRenderer {
+
+    /// The width and height of a tile in device pixels.
+    public var tileSize = 256
+
+    /// The number of workers pulling tiles off the shared tile queue. They
+    /// run on a global dispatch queue, which doesn't run more of them at once
+    /// than there are cores, so counts above that don't add threads.
+    public var threadCount = NSProcessInfo.processInfo().activeProcessorCount
+
+    /// When set strokes are drawn by filling their outlines from the
+    /// stroker, outlined at the scale of the bitmap being rendered.
+    public var stroker: SVGStroker? = .None
+
+    public init() {
+    }
+
+    /// The transform from the document's viewBox to a bitmap of size with
+    /// its origin at the bottom left.
+    public class func documentTransform(svgDocument: SVGDocument, size: CGSize) -> CGAffineTransform {
+        return documentTransform(viewBox: svgDocument.viewBox, size: size)
+    }
+
+    public class func documentTransform(viewBox viewBox: CGRect?, size: CGSize) -> CGAffineTransform {
+        let viewBox = viewBox ?? CGRect(origin: CGPoint.zero, size: size)
+        let scaleX = viewBox.width > 0.0 ? size.width / viewBox.width : 1.0
+        let scaleY = viewBox.height > 0.0 ? size.height / viewBox.height : 1.0
+        var transform = CGAffineTransformMakeTranslation(0.0, size.height)
+        transform = CGAffineTransformScale(transform, scaleX, -scaleY)
+        return CGAffineTransformTranslate(transform, -viewBox.origin.x, -viewBox.origin.y)
+    }
+
+    /// Creates the bitmap context used for both tiled and untiled rendering.
+    public class func makeBitmapContext(width: Int, height: Int, data: UnsafeMutablePointer<Void> = nil,
+                                        bytesPerRow: Int = 0) -> CGContext? {
+        let colorSpace = CGColorSpaceCreateWithName(kCGColorSpaceSRGB)
+        let bitmapInfo = CGImageAlphaInfo.PremultipliedLast.rawValue
+        let context = CGBitmapContextCreate(data, width, height, 8, bytesPerRow, colorSpace, bitmapInfo)
+        if let context = context {
+            CGContextSetTextMatrix(context, CGAffineTransformIdentity)
+        }
+        return context
+    }
+
+    /// The device pixels per document unit of transform.
+    internal class func scale(transform: CGAffineTransform) -> CGFloat {
+        return sqrt(abs(transform.a * transform.d - transform.b * transform.c))
+    }
+
+    /// Renders the whole document on the calling thread. This is the
+    /// reference the tiled output is compared against, so a fractional size
+    /// is rounded up the same way.
+    public class func renderDocumentUntiled(svgDocument: SVGDocument, size: CGSize,
+                                            stroker: SVGStroker? = .None) throws -> CGImage? {
+        let width = Int(ceil(size.width))
+        let height = Int(ceil(size.height))
+        guard width > 0 && height > 0, let context = makeBitmapContext(width, height: height) else {
+            return .None
+        }
+        let transform = documentTransform(svgDocument, size: size)
+        CGContextConcatCTM(context, transform)
+        let svgRenderer = SVGRenderer()
+        svgRenderer.stroker = stroker
+        svgRenderer.strokeScale = scale(transform)
+        try svgRenderer.renderDocument(svgDocument, renderer: context)
+        return CGBitmapContextCreateImage(context)
+    }
+
+    public func renderDocument(svgDocument: SVGDocument, size: CGSize) throws -> CGImage? {
+        guard let stroker = stroker else {
+            return try renderDocument(svgDocument.freeze(), size: size)
+        }
+        // Outlines depend on the scale, so aren't in the document's own
+        // display list.
+        let strokeScale = SVGTiledRenderer.scale(SVGTiledRenderer.documentTransform(svgDocument, size: size))
+        let displayList = try SVGDisplayList(svgDocument: svgDocument, stroker: stroker, strokeScale: strokeScale)
+        return try renderDocument(SVGFrozenDocument(svgDocument: svgDocument, displayList: displayList), size: size)
+    }
+
+    /// Renders a frozen document. Several renderers can render the same
+    /// frozen document at once, for example at different sizes.
+    public func renderDocument(frozenDocument: SVGFrozenDocument, size: CGSize) throws -> CGImage? {
+        let width = Int(ceil(size.width))
+        let height = Int(ceil(size.height))
+        guard width > 0 && height > 0 && tileSize > 0,
+            let context = SVGTiledRenderer.makeBitmapContext(width, height: height) else {
+            return .None
+        }
+
+        let transform = SVGTiledRenderer.documentTransform(viewBox: frozenDocument.viewBox, size: size)
+        let columns = (width + tileSize - 1) / tileSize
+        let rows = (height + tileSize - 1) / tileSize
+        var binner = TileBinner(tileSize: tileSize, columns: columns, rows: rows, height: height)
+        for (index, bounds) in frozenDocument.elementBounds.enumerate() {
+            binner.bin(index, bounds: bounds, transform: transform)
+        }
+        let bins = binner.bins
+
+        let baseAddress = UnsafeMutablePointer<UInt8>(CGBitmapContextGetData(context))
+        let bytesPerRow = CGBitmapContextGetBytesPerRow(context)
+
+        let nextTile = UnsafeMutablePointer<Int32>.alloc(1)
+        nextTile.initialize(-1)
+        defer {
+            nextTile.dealloc(1)
+        }
+        let errorLock = NSLock()
+        var renderError: ErrorType? = .None
+
+        let queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0)
+        dispatch_apply(max(1, threadCount), queue) { _ in
+            while true {
+                let tileIndex = Int(OSAtomicIncrement32(nextTile))
+                if tileIndex >= bins.count {
+                    break
+                }
+                let bin = bins[tileIndex]
+                if bin.isEmpty {
+                    continue
+                }
+                let column = tileIndex % columns
+                let row = tileIndex / columns
+                let tileX = column * self.tileSize
+                let tileY = row * self.tileSize // Measured down from the top row of the bitmap.
+                let tileWidth = min(self.tileSize, width - tileX)
+                let tileHeight = min(self.tileSize, height - tileY)
+
+                let tileData = baseAddress.advancedBy(tileY * bytesPerRow + tileX * 4)
+                guard let tileContext = SVGTiledRenderer.makeBitmapContext(tileWidth, height: tileHeight,
+                                                    data: tileData, bytesPerRow: bytesPerRow) else {
+                    continue
+                }
+                let tileOriginY = CGFloat(height - tileY - tileHeight)
+                CGContextTranslateCTM(tileContext, CGFloat(-tileX), -tileOriginY)
+                CGContextConcatCTM(tileContext, transform)
+
+                do {
+                    try frozenDocument.render(tileContext) { bin.contains($0) }
+                }
+                catch let error {
+                    errorLock.lock()
+                    renderError = renderError ?? error
+                    errorLock.unlock()
+                }
+            }
+        }
+
+        if let error = renderError {
+            throw error
+        }
+        return CGBitmapContextCreateImage(context)
+    }
+}
+
+// MARK: -
+
+/// Assigns elements to the tiles covered by their device space bounds.
+/// Element bounds already cover their descendants, so a container is in
+/// every bin one of its descendants is in and the tile descends into it.
+private struct TileBinner {
+    let tileSize: Int
+    let columns: Int
+    let rows: Int
+    let height: Int
+    var bins: [Set<Int>]
+
+    init(tileSize: Int, columns: Int, rows: Int, height: Int) {
+        self.tileSize = tileSize
+        self.columns = columns
+        self.rows = rows
+        self.height = height
+        self.bins = [Set<Int>](count: columns * rows, repeatedValue: Set<Int>())
+    }
+
+    mutating func bin(elementIndex: Int, bounds: CGRect, transform: CGAffineTransform) {
+        if bounds.isNull {
+            return
+        }
+        // Text extents are not known without laying the text out, so text
+        // goes into every tile.
+        let deviceBounds = bounds.isInfinite ? bounds : CGRectApplyAffineTransform(bounds, transform)
+        for tile in tilesForDeviceRect(deviceBounds) {
+            bins[tile].insert(elementIndex)
+        }
+    }
+
+    func tilesForDeviceRect(rect: CGRect) -> Set<Int> {
+        if rect.isNull || rect.isInfinite {
+            return Set(0..<bins.count)
+        }
+        // Outset by a pixel for antialiasing. Device space has its origin at
+        // the bottom left while tile rows count down from the top.
+        let minColumn = max(0, Int(floor((rect.minX - 1.0) / CGFloat(tileSize))))
+        let maxColumn = min(columns - 1, Int(floor((rect.maxX + 1.0) / CGFloat(tileSize))))
+        let minRow = max(0, Int(floor((CGFloat(height) - rect.maxY - 1.0) / CGFloat(tileSize))))
+        let maxRow = min(rows - 1, Int(floor((CGFloat(height) - rect.minY + 1.0) / CGFloat(tileSize))))
+        var tiles = Set<Int>()
+        if minColumn > maxColumn || minRow > maxRow {
+            return tiles
+        }
+        for row in minRow...maxRow {
+            for column in minColumn...maxColumn {
+                tiles.insert(row * columns + column)
+            }
+        }
+        return tiles
+    }
+}
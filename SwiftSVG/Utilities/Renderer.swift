@@ -26,6 +26,8 @@ public protocol Renderer: AnyObject {
     func drawText(textRenderer: TextRenderer)
     func drawLinearGradient(linearGradient: LinearGradientRenderer,
                                    pathGenerator: PathGenerator)
+    func drawRadialGradient(radialGradient: RadialGradientRenderer,
+                                   pathGenerator: PathGenerator)
     func fillPath()
     
     func render() -> String
@@ -37,6 +39,14 @@ public protocol Renderer: AnyObject {
     var style:Style { get set }
 }
 
+/// A renderer that can count the bytes of output it has produced so far.
+public protocol OutputMeasuringRenderer: Renderer {
+    /// Counting is off until this is set, as it can cost as much as
+    /// producing the output.
+    var measuresOutput: Bool { get set }
+    var outputByteCount: Int { get }
+}
+
 // MARK: -
 
 public protocol CustomSourceConvertible {
@@ -121,9 +131,82 @@ extension CGContext: Renderer {
         else {
             CGContextClip(self)
         }
-        CGContextDrawLinearGradient(self, theGradient, start, end, CGGradientDrawingOptions())
+        if linearGradient.spreadMethod == .pad {
+            let options: CGGradientDrawingOptions = [.DrawsBeforeStartLocation, .DrawsAfterEndLocation]
+            CGContextDrawLinearGradient(self, theGradient, start, end, options)
+        }
+        else if let ramp = linearGradient.ramp {
+            let axis = CGVector(dx: end.x - start.x, dy: end.y - start.y)
+            let lengthSquared = axis.dx * axis.dx + axis.dy * axis.dy
+            if lengthSquared > 0.0 {
+                drawGradientRamp() { rowStart, dx, span, count in
+                    let t0 = ((rowStart.x - start.x) * axis.dx + (rowStart.y - start.y) * axis.dy) / lengthSquared
+                    let dt = dx * axis.dx / lengthSquared
+                    ramp.fillLinearSpan(span, count: count, t0: Float(t0), dt: Float(dt))
+                }
+            }
+        }
         self.restoreGraphicsState()
     }
+
+    public func drawRadialGradient(radialGradient: RadialGradientRenderer,
+                                    pathGenerator: PathGenerator) {
+        guard let theGradient = radialGradient.radialGradient else {
+            return
+        }
+
+        self.pushGraphicsState()
+        self.addPath(pathGenerator)
+        if pathGenerator.evenOdd {
+            CGContextEOClip(self)
+        }
+        else {
+            CGContextClip(self)
+        }
+        CGContextConcatCTM(self, radialGradient.gradientTransform)
+        let focal = radialGradient.focalPoint
+        let center = radialGradient.centerPoint
+        if radialGradient.spreadMethod == .pad {
+            let options: CGGradientDrawingOptions = [.DrawsBeforeStartLocation, .DrawsAfterEndLocation]
+            CGContextDrawRadialGradient(self, theGradient, focal, 0.0, center, radialGradient.radius, options)
+        }
+        else if let ramp = radialGradient.ramp {
+            let relativeCenter = CGPoint(x: center.x - focal.x, y: center.y - focal.y)
+            drawGradientRamp() { rowStart, dx, span, count in
+                let point = CGPoint(x: rowStart.x - focal.x, y: rowStart.y - focal.y)
+                ramp.fillRadialSpan(span, count: count, point: point, step: CGVector(dx: dx, dy: 0.0),
+                                    center: relativeCenter, radius: radialGradient.radius)
+            }
+        }
+        self.restoreGraphicsState()
+    }
+
+    // CoreGraphics gradients can only pad, so reflected and repeated gradients
+    // are filled in software from the gradient's ramp. The image covers the
+    // clip bounds at device resolution, and fillRow is given the user space
+    // center of each row's first pixel and the user space width of a pixel.
+    private func drawGradientRamp(fillRow: (rowStart: CGPoint, dx: CGFloat,
+                                  span: UnsafeMutablePointer<UInt32>, count: Int) -> Void) {
+        let bounds = CGContextGetClipBoundingBox(self)
+        if bounds.isEmpty || bounds.isInfinite {
+            return
+        }
+        let deviceBounds = CGContextConvertRectToDeviceSpace(self, bounds)
+        let maximumSize: CGFloat = 4096.0
+        let width = Int(ceil(min(deviceBounds.width, maximumSize)))
+        let height = Int(ceil(min(deviceBounds.height, maximumSize)))
+        let dx = bounds.width / CGFloat(width)
+        let dy = bounds.height / CGFloat(height)
+        // CGContextDrawImage puts the first row of the image at the maximum y
+        // of the destination rect in user space.
+        let image = SVGGradientRamp.makeImage(width, height: height) { row, span in
+            let rowStart = CGPoint(x: bounds.minX + 0.5 * dx, y: bounds.maxY - (CGFloat(row) + 0.5) * dy)
+            fillRow(rowStart: rowStart, dx: dx, span: span, count: width)
+        }
+        if let image = image {
+            CGContextDrawImage(self, bounds, image)
+        }
+    }
     
     public func fillPath() {
         CGContextFillPath(self)
@@ -134,7 +217,7 @@ extension CGContext: Renderer {
 
 //MARK: - MovingImagesRenderer
 
-public class MovingImagesRenderer: Renderer {
+public class MovingImagesRenderer: OutputMeasuringRenderer {
     
     class MIRenderElement: Node {
         internal typealias ParentType = MIRenderContainer
@@ -167,6 +250,16 @@ public class MovingImagesRenderer: Renderer {
     
     internal var rootElement = MIRenderContainer()
     private var current: MIRenderElement
+
+    public var measuresOutput = false
+
+    /// When true each distinct svgpath is written once, in an svgpaths array
+    /// at the top level, and elements refer to it by svgpathindex.
+    public var sharesPaths = false
+
+    /// The size of each element's properties as compact JSON, counted as
+    /// the element ends. Containers are counted without their children.
+    public private(set) var outputByteCount = 0
     
     // internal var movingImagesJSON: [NSString : AnyObject]
     
@@ -221,7 +314,7 @@ public class MovingImagesRenderer: Renderer {
 
     public func addPath(path:PathGenerator) {
         if let svgPath = path.svgpath {
-            current.movingImages[MIJSONKeySVGPath] = svgPath
+            addSVGPath(svgPath)
             return
         }
 
@@ -245,7 +338,27 @@ public class MovingImagesRenderer: Renderer {
         }
     
         if let svgPath = pathGenerator.svgpath {
-            current.movingImages[MIJSONKeySVGPath] = svgPath
+            addSVGPath(svgPath)
+        }
+        else if let mipath = pathGenerator.mipath {
+            for (key, value) in mipath {
+                current.movingImages[key] = value
+            }
+        }
+
+        for (key, value) in gradient {
+            current.movingImages[key] = value
+        }
+    }
+
+    public func drawRadialGradient(radialGradient: RadialGradientRenderer,
+                                    pathGenerator: PathGenerator) {
+        guard let gradient = radialGradient.miRadialGradient else {
+            return
+        }
+    
+        if let svgPath = pathGenerator.svgpath {
+            addSVGPath(svgPath)
         }
         else if let mipath = pathGenerator.mipath {
             for (key, value) in mipath {
@@ -259,6 +372,13 @@ public class MovingImagesRenderer: Renderer {
     }
 
     public func endElement() {
+        if measuresOutput {
+            let properties = current.movingImages as NSDictionary
+            if NSJSONSerialization.isValidJSONObject(properties),
+                let data = try? NSJSONSerialization.dataWithJSONObject(properties, options: []) {
+                outputByteCount += data.length
+            }
+        }
         if let parent = self.current.parent {
             self.current = parent
         }
@@ -299,8 +419,31 @@ public class MovingImagesRenderer: Renderer {
         }
     }
 
+    private var sharedPaths = [String]()
+    private var sharedPathIndexes = [String : Int]()
+
+    private func addSVGPath(svgPath: String) {
+        guard sharesPaths else {
+            current.movingImages[MIJSONKeySVGPath] = svgPath
+            return
+        }
+        let index: Int
+        if let sharedIndex = sharedPathIndexes[svgPath] {
+            index = sharedIndex
+        }
+        else {
+            index = sharedPaths.count
+            sharedPaths.append(svgPath)
+            sharedPathIndexes[svgPath] = index
+        }
+        current.movingImages[MIJSONKeySVGPathIndex] = index
+    }
+
     // Not part of the Render protocol.
     public func generateJSONDict() -> [NSString : AnyObject] {
+        if !sharedPaths.isEmpty {
+            rootElement.movingImages[MIJSONKeySVGPaths] = sharedPaths
+        }
         return rootElement.generateJSONDict()
     }
     
@@ -311,6 +454,11 @@ public class MovingImagesRenderer: Renderer {
         return ""
     }
 
+    /// The JSON written with options to control rounding and path data.
+    public func render(options: MIJSONWriterOptions) -> String {
+        return jsonObjectToString(self.generateJSONDict(), options: options) ?? ""
+    }
+
     public func fillPath() { }
 
     public var strokeColor:CGColor? {
@@ -477,6 +625,11 @@ public class SourceCodeRenderer: Renderer {
         
     }
 
+    public func drawRadialGradient(radialGradient: RadialGradientRenderer,
+                                    pathGenerator: PathGenerator) {
+        
+    }
+
     public func fillPath() {
         source += "CGContextFillPath(context)\n"
     }
@@ -0,0 +1,236 @@
+//
+//  SVGInstrumentation.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+/// Timings, counters and histograms from processing, rendering and
+/// serializing documents, for a host to query or export. Recording is off
+/// by default, when every call costs a check of enabled and counter names
+/// are never built. Recording is thread safe.
+///
+/// Phases nest, so the time of elements includes the time of style,
+/// transforms and paths. Phases timed on several threads at once add up
+/// the time of each thread.
+///
+/// Counter names are a category and a name joined by a dot, for example
+/// "elements.path", "segments.curveTo", "bytes.in" or
+/// "unhandledAttributes.class".
+///
+/// Work done for a particular consumer, like rendering to a CGContext, can
+/// be attributed to it with attribute, which counters can include in their
+/// names.
+public struct SVGInstrumentation {
+    public enum Phase: String {
+        case xml
+        case elements
+        case style
+        case transforms
+        case paths
+        case render
+        case serialize
+
+        public static let allPhases: [Phase] = [.xml, .elements, .style, .transforms, .paths, .render, .serialize]
+    }
+
+    /// Counts of values in buckets whose upper bounds double from 1, with
+    /// the last bucket open ended.
+    public struct Histogram {
+        public static let bucketCount = 32
+
+        public private(set) var bucketCounts = [Int](count: Histogram.bucketCount, repeatedValue: 0)
+        public private(set) var count = 0
+        public private(set) var sum = 0.0
+        public private(set) var minimum = Double.infinity
+        public private(set) var maximum = -Double.infinity
+
+        public var mean: Double {
+            return count == 0 ? 0.0 : sum / Double(count)
+        }
+
+        /// The upper bound of the bucket holding the value at fraction of
+        /// the way through the sorted values.
+        public func percentile(fraction: Double) -> Double {
+            let target = Int(ceil(Double(count) * max(0.0, min(1.0, fraction))))
+            var seen = 0
+            for (index, bucketCount) in bucketCounts.enumerate() {
+                seen += bucketCount
+                if seen >= target && bucketCount > 0 {
+                    return min(Histogram.upperBound(index), maximum)
+                }
+            }
+            return maximum
+        }
+
+        static func upperBound(bucket: Int) -> Double {
+            return bucket == Histogram.bucketCount - 1 ? Double.infinity : pow(2.0, Double(bucket))
+        }
+
+        mutating func record(value: Double) {
+            var bucket = 0
+            while bucket < Histogram.bucketCount - 1 && value > Histogram.upperBound(bucket) {
+                bucket += 1
+            }
+            bucketCounts[bucket] += 1
+            count += 1
+            sum += value
+            minimum = min(minimum, value)
+            maximum = max(maximum, value)
+        }
+    }
+
+    /// A copy of everything recorded so far.
+    public struct Snapshot {
+        /// Total seconds in each phase.
+        public let phaseTimes: [Phase: Double]
+        public let phaseCalls: [Phase: Int]
+        public let counters: [String: Int]
+        /// Phase calls are also recorded in microseconds in histograms named
+        /// "phase." followed by the phase.
+        public let histograms: [String: Histogram]
+
+        /// The counters in category, by the rest of their names.
+        public func counters(category: String) -> [String: Int] {
+            let prefix = category + "."
+            var result = [String: Int]()
+            for (name, value) in counters where name.hasPrefix(prefix) {
+                result[name.substringFromIndex(prefix.endIndex)] = value
+            }
+            return result
+        }
+
+        /// The snapshot as dictionaries, arrays, strings and numbers for
+        /// writing as JSON.
+        public var jsonObject: [String: AnyObject] {
+            var phases = [String: AnyObject]()
+            for phase in Phase.allPhases where phaseCalls[phase] != nil {
+                phases[phase.rawValue] = [
+                    "seconds": phaseTimes[phase] ?? 0.0,
+                    "calls": phaseCalls[phase] ?? 0
+                ]
+            }
+            var histogramObjects = [String: AnyObject]()
+            for (name, histogram) in histograms {
+                histogramObjects[name] = [
+                    "count": histogram.count,
+                    "sum": histogram.sum,
+                    "min": histogram.minimum,
+                    "max": histogram.maximum,
+                    "p50": histogram.percentile(0.5),
+                    "p99": histogram.percentile(0.99)
+                ]
+            }
+            return [
+                "phases": phases,
+                "counters": counters,
+                "histograms": histogramObjects
+            ]
+        }
+    }
+
+    public static var enabled = false
+
+    /// Times body as part of phase.
+    public static func time<T>(phase: Phase, @noescape _ body: () throws -> T) rethrows -> T {
+        guard enabled else {
+            return try body()
+        }
+        let start = mach_absolute_time()
+        defer {
+            addTime(phase, ticks: mach_absolute_time() - start)
+        }
+        return try body()
+    }
+
+    /// Runs body with what is counted on this thread on behalf of a consumer,
+    /// like the geometry built for it, attributed to consumer.
+    public static func attribute<T>(consumer: String, @noescape _ body: () throws -> T) rethrows -> T {
+        guard enabled else {
+            return try body()
+        }
+        let threadDictionary = NSThread.currentThread().threadDictionary
+        let previousConsumer = threadDictionary[consumerKey]
+        threadDictionary[consumerKey] = consumer
+        defer {
+            threadDictionary[consumerKey] = previousConsumer
+        }
+        return try body()
+    }
+
+    /// The consumer set by attribute on this thread, or "none".
+    public static var consumer: String {
+        return NSThread.currentThread().threadDictionary[consumerKey] as? String ?? "none"
+    }
+
+    public static func count(@autoclosure name: () -> String, by amount: Int = 1) {
+        guard enabled else {
+            return
+        }
+        let counterName = name()
+        lock.lock()
+        counters[counterName] = (counters[counterName] ?? 0) + amount
+        lock.unlock()
+    }
+
+    public static func record(@autoclosure histogram: () -> String, value: Double) {
+        guard enabled else {
+            return
+        }
+        let histogramName = histogram()
+        lock.lock()
+        var updated = histograms[histogramName] ?? Histogram()
+        updated.record(value)
+        histograms[histogramName] = updated
+        lock.unlock()
+    }
+
+    public static func snapshot() -> Snapshot {
+        lock.lock()
+        defer {
+            lock.unlock()
+        }
+        var phaseTimes = [Phase: Double]()
+        for (phase, ticks) in phaseTicks {
+            phaseTimes[phase] = Double(ticks) * secondsPerTick
+        }
+        return Snapshot(phaseTimes: phaseTimes, phaseCalls: phaseCalls, counters: counters, histograms: histograms)
+    }
+
+    public static func reset() {
+        lock.lock()
+        phaseTicks = [: ]
+        phaseCalls = [: ]
+        counters = [: ]
+        histograms = [: ]
+        lock.unlock()
+    }
+
+    // MARK: -
+
+    private static let lock = NSLock()
+    private static let consumerKey = "SVGInstrumentation.consumer"
+    private static var phaseTicks = [Phase: UInt64]()
+    private static var phaseCalls = [Phase: Int]()
+    private static var counters = [String: Int]()
+    private static var histograms = [String: Histogram]()
+
+    internal static let secondsPerTick: Double = {
+        var timebase = mach_timebase_info_data_t()
+        mach_timebase_info(&timebase)
+        return Double(timebase.numer) / Double(timebase.denom) * 1.0e-9
+    }()
+
+    private static func addTime(phase: Phase, ticks: UInt64) {
+        lock.lock()
+        phaseTicks[phase] = (phaseTicks[phase] ?? 0) + ticks
+        phaseCalls[phase] = (phaseCalls[phase] ?? 0) + 1
+        var histogram = histograms["phase." + phase.rawValue] ?? Histogram()
+        histogram.record(Double(ticks) * secondsPerTick * 1.0e6)
+        histograms["phase." + phase.rawValue] = histogram
+        lock.unlock()
+    }
+}
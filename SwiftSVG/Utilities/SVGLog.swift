@@ -0,0 +1,37 @@
+//
+//  SVGLog.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+/// Diagnostics from parsing and rendering. Messages are autoclosures so
+/// when a message's level is not enabled the string is never built.
+/// Logging is off by default.
+public struct SVGLog {
+    public enum Level: Int {
+        case off
+        case warning
+        case debug
+    }
+
+    public static var level = Level.off
+
+    /// Where enabled messages are sent.
+    public static var handler: (String) -> Void = { print($0) }
+
+    public static func warning(@autoclosure message: () -> String) {
+        if level.rawValue >= Level.warning.rawValue {
+            handler(message())
+        }
+    }
+
+    public static func debug(@autoclosure message: () -> String) {
+        if level.rawValue >= Level.debug.rawValue {
+            handler(message())
+        }
+    }
+}
@@ -0,0 +1,147 @@
+//
+//  SVGNumberFormatter.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+/// Formats numbers for written output using as few characters as the
+/// precision allows.
+public struct SVGNumberFormatter {
+    public enum Precision {
+        /// The shortest text that reads back as exactly the same double.
+        case shortest
+        /// Rounded to a number of decimal places.
+        case decimalPlaces(Int)
+        /// Rounded to the nearest multiple of a grid spacing.
+        case quantum(Double)
+    }
+
+    public let precision: Precision
+
+    // The decimal places needed to write a rounded value exactly, and the
+    // power of ten for them.
+    private let places: Int
+    private let scale: Double
+
+    public init(precision: Precision = .shortest) {
+        self.precision = precision
+        switch precision {
+            case .shortest:
+                places = 0
+            case .decimalPlaces(let decimalPlaces):
+                places = min(max(decimalPlaces, 0), 15)
+            case .quantum(let quantum):
+                // The fewest places that represent every multiple of quantum.
+                var quantumPlaces = 0
+                while quantumPlaces < 15 {
+                    let scaled = quantum * pow(10.0, Double(quantumPlaces))
+                    if abs(scaled - round(scaled)) < 1.0e-9 * max(1.0, scaled) {
+                        break
+                    }
+                    quantumPlaces += 1
+                }
+                places = quantumPlaces
+        }
+        scale = pow(10.0, Double(places))
+    }
+
+    /// The value rounded as it will be written.
+    public func quantize(value: Double) -> Double {
+        switch precision {
+            case .shortest:
+                return value
+            case .decimalPlaces:
+                return round(value * scale) / scale
+            case .quantum(let quantum):
+                return quantum > 0.0 ? round(value / quantum) * quantum : value
+        }
+    }
+
+    public func format(value: Double) -> String {
+        if !value.isFinite {
+            return "0"
+        }
+        switch precision {
+            case .shortest:
+                return formatShortest(value)
+            case .decimalPlaces, .quantum:
+                let scaled = round(quantize(value) * scale)
+                if abs(scaled) >= 9.0e15 {
+                    return formatShortest(value)
+                }
+                return formatFixed(Int64(scaled), places: places)
+        }
+    }
+
+    public func format(value: CGFloat) -> String {
+        return format(Double(value))
+    }
+
+    // The value is written with integer arithmetic as a whole number of
+    // units of the last of places decimal places, dropping trailing zeros.
+    private func formatFixed(units: Int64, places: Int) -> String {
+        if units == 0 {
+            return "0"
+        }
+        let magnitude = units < 0 ? -units : units
+        let divisor = Int64(SVGNumberFormatter.powersOfTen[places])
+        var string = units < 0 ? "-" : ""
+        string += String(magnitude / divisor)
+        var fraction = magnitude % divisor
+        if fraction == 0 {
+            return string
+        }
+        var digits = places
+        while fraction % 10 == 0 {
+            fraction /= 10
+            digits -= 1
+        }
+        let fractionString = String(fraction)
+        string += "." + String(count: digits - fractionString.characters.count, repeatedValue: Character("0"))
+        return string + fractionString
+    }
+
+    private static let shortestFixedPlaces = 8
+    private static let powersOfTen: [Double] = (0...15).map() { pow(10.0, Double($0)) }
+
+    // Whole numbers are written as integers. Most coordinates were parsed
+    // from text with a few decimal places, so those are tried next with
+    // integer arithmetic: n / 10^p, with both exact as doubles, is correctly
+    // rounded, so it equals the value exactly when strtod would read the
+    // text back as the value. The first p that works is the fewest digits.
+    // Anything else goes through printf at 15 significant digits, which
+    // reproduces any number parsed from decimal text of up to 15 digits,
+    // with 16 and 17 as the fallbacks.
+    private func formatShortest(value: Double) -> String {
+        if value == 0.0 {
+            return "0"
+        }
+        if value == round(value) && abs(value) < 9.0e15 {
+            return String(Int64(value))
+        }
+        // Below 0.001 the exponent form printf writes is shorter.
+        if abs(value) >= 0.001 {
+            for places in 1...SVGNumberFormatter.shortestFixedPlaces {
+                let powerOfTen = SVGNumberFormatter.powersOfTen[places]
+                let units = round(value * powerOfTen)
+                if abs(units) >= 9.0e15 {
+                    break
+                }
+                if units / powerOfTen == value {
+                    return formatFixed(Int64(units), places: places)
+                }
+            }
+        }
+        for significantDigits in 15...17 {
+            let string = String(format: "%.*g", significantDigits, value)
+            if strtod_l(string, nil, cNumericLocale) == value || significantDigits == 17 {
+                return string
+            }
+        }
+        return String(value)
+    }
+}
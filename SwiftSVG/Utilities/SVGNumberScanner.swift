@@ -0,0 +1,187 @@
+//
+//  SVGNumberScanner.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+/// Reads numbers directly from the UTF-8 bytes of an attribute value,
+/// without splitting it into substrings or creating number formatters.
+/// Numbers are read independently of the current locale.
+internal struct SVGNumberScanner {
+    private var position: UnsafePointer<UInt8>
+    private let end: UnsafePointer<UInt8>
+
+    init(start: UnsafePointer<UInt8>, count: Int) {
+        self.position = start
+        self.end = start.advancedBy(count)
+    }
+
+    /// Calls body with a scanner over the bytes of string. For an NSString
+    /// that already holds UTF-8 or ASCII, the bytes are read in place.
+    static func scan<Result>(string: String, @noescape body: (inout SVGNumberScanner) throws -> Result) rethrows -> Result {
+        let nsString = string as NSString
+        return try withExtendedLifetime(nsString) {
+            let cString = nsString.UTF8String
+            var scanner = SVGNumberScanner(start: UnsafePointer<UInt8>(cString), count: Int(strlen(cString)))
+            return try body(&scanner)
+        }
+    }
+
+    var atEnd: Bool {
+        return position >= end
+    }
+
+    /// The next byte without consuming it, or nil at the end.
+    var peek: UInt8? {
+        return atEnd ? .None : position.memory
+    }
+
+    mutating func skipByte() {
+        position = position.successor()
+    }
+
+    mutating func skipWhitespace() {
+        while !atEnd && isWhitespace(position.memory) {
+            position = position.successor()
+        }
+    }
+
+    /// Skips white space with at most one comma in it.
+    mutating func skipSeparator() {
+        skipWhitespace()
+        if peek == UInt8(ascii: ",") {
+            position = position.successor()
+            skipWhitespace()
+        }
+    }
+
+    /// Reads a number such as "-1.5e3", ".5" or "10". Returns nil, without
+    /// consuming anything, if there is no number at the current position.
+    mutating func scanNumber() -> Double? {
+        let start = position
+        var cursor = position
+        var negative = false
+        if cursor < end && (cursor.memory == UInt8(ascii: "-") || cursor.memory == UInt8(ascii: "+")) {
+            negative = cursor.memory == UInt8(ascii: "-")
+            cursor = cursor.successor()
+        }
+
+        // Up to 19 significant digits fit in the mantissa.
+        var mantissa: UInt64 = 0
+        var significantDigits = 0
+        var exponent = 0
+        var digitCount = 0
+        while cursor < end && isDigit(cursor.memory) {
+            if significantDigits < 19 {
+                mantissa = mantissa * 10 + UInt64(cursor.memory - UInt8(ascii: "0"))
+                if mantissa > 0 {
+                    significantDigits += 1
+                }
+            }
+            else {
+                exponent += 1
+            }
+            digitCount += 1
+            cursor = cursor.successor()
+        }
+        if cursor < end && cursor.memory == UInt8(ascii: ".") {
+            cursor = cursor.successor()
+            while cursor < end && isDigit(cursor.memory) {
+                if significantDigits < 19 {
+                    mantissa = mantissa * 10 + UInt64(cursor.memory - UInt8(ascii: "0"))
+                    exponent -= 1
+                    if mantissa > 0 {
+                        significantDigits += 1
+                    }
+                }
+                digitCount += 1
+                cursor = cursor.successor()
+            }
+        }
+        if digitCount == 0 {
+            return .None
+        }
+
+        // An e only starts an exponent when digits follow, so "1em" is one
+        // followed by a unit.
+        if cursor < end && (cursor.memory == UInt8(ascii: "e") || cursor.memory == UInt8(ascii: "E")) {
+            var exponentCursor = cursor.successor()
+            var exponentNegative = false
+            if exponentCursor < end && (exponentCursor.memory == UInt8(ascii: "-") || exponentCursor.memory == UInt8(ascii: "+")) {
+                exponentNegative = exponentCursor.memory == UInt8(ascii: "-")
+                exponentCursor = exponentCursor.successor()
+            }
+            if exponentCursor < end && isDigit(exponentCursor.memory) {
+                var exponentValue = 0
+                while exponentCursor < end && isDigit(exponentCursor.memory) {
+                    exponentValue = min(exponentValue * 10 + Int(exponentCursor.memory - UInt8(ascii: "0")), 10000)
+                    exponentCursor = exponentCursor.successor()
+                }
+                exponent += exponentNegative ? -exponentValue : exponentValue
+                cursor = exponentCursor
+            }
+        }
+        position = cursor
+
+        // When the mantissa and the power of ten are both exactly
+        // representable a single multiply or divide is correctly rounded.
+        // Anything else goes to strtod_l in the C locale, so a locale with a
+        // decimal comma doesn't stop at the point.
+        let value: Double
+        if mantissa < (1 << 53) && exponent >= -22 && exponent <= 22 {
+            let power = exactPowersOfTen[abs(exponent)]
+            value = exponent < 0 ? Double(mantissa) / power : Double(mantissa) * power
+        }
+        else {
+            var bytes = [Int8](count: cursor - start + 1, repeatedValue: 0)
+            for index in 0..<(cursor - start) {
+                bytes[index] = Int8(bitPattern: start[index])
+            }
+            return strtod_l(bytes, nil, cNumericLocale)
+        }
+        return negative ? -value : value
+    }
+
+    /// Reads numbers separated by white space and commas until the end. Returns
+    /// nil if anything else is found.
+    mutating func scanNumberList() -> [Double]? {
+        var numbers = [Double]()
+        skipWhitespace()
+        while !atEnd {
+            guard let number = scanNumber() else {
+                return .None
+            }
+            numbers.append(number)
+            skipSeparator()
+        }
+        return numbers
+    }
+
+    /// The remaining bytes as a string, for units and the like.
+    mutating func scanRemainder() -> String {
+        let remainder = String(bytes: UnsafeBufferPointer(start: position, count: end - position),
+                               encoding: NSUTF8StringEncoding) ?? ""
+        position = end
+        return remainder
+    }
+}
+
+/// The C locale for parsing numbers with strtod_l.
+internal let cNumericLocale = newlocale(LC_NUMERIC_MASK, "C", nil)
+
+private let exactPowersOfTen: [Double] = [
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+]
+
+private func isDigit(byte: UInt8) -> Bool {
+    return byte >= UInt8(ascii: "0") && byte <= UInt8(ascii: "9")
+}
+
+private func isWhitespace(byte: UInt8) -> Bool {
+    return byte == 0x20 || byte == 0x09 || byte == 0x0A || byte == 0x0D || byte == 0x0C
+}
@@ -0,0 +1,227 @@
+//
+//  SVGSyntheticDocument.swift
+//  SwiftSVG
+//
+//  Created by Kevin Meaney on 18/10/2026.
+//  Copyright © 2026 No. All rights reserved.
+//
+
+import Foundation
+
+@testable import SwiftSVG
+
+/// SplitMix64, so the same seed gives the same document on every machine.
+struct SeededRandom {
+    private var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state = state &+ 0x9E3779B97F4A7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+        z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+        return z ^ (z >> 31)
+    }
+
+    /// A value in 0..<1.
+    mutating func nextDouble() -> Double {
+        return Double(next() >> 11) / Double(1 << 53)
+    }
+
+    mutating func nextDouble(range: ClosedInterval<Double>) -> Double {
+        return range.start + nextDouble() * (range.end - range.start)
+    }
+
+    mutating func nextInt(upperBound: Int) -> Int {
+        return Int(next() % UInt64(upperBound))
+    }
+}
+
+/// Generates SVG source whose size along one dimension can be varied with
+/// the others held still, for measuring how the cost of processing,
+/// optimising, rendering and exporting grows.
+struct SVGSyntheticDocument {
+    /// Path elements drawn directly, not counting the instanced shape.
+    var elementCount = 200
+    /// Path elements are put in runs of runLength, each run nested this many
+    /// groups deep.
+    var nestingDepth = 1
+    var runLength = 8
+    /// Segments in each path.
+    var pathLength = 8
+    /// The fraction of paths and groups with a transform.
+    var transformDensity = 0.0
+    /// The number of use elements instancing one shared shape.
+    var useFanOut = 0
+    /// Fills are chosen from this many colors. Fewer colors mean more
+    /// neighbouring paths with the same style for optimise to combine.
+    var colorCount = 4
+    var seed: UInt64 = 1
+
+    var source: String {
+        var random = SeededRandom(seed: seed)
+        var lines = [
+            "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" " +
+            "version=\"1.1\" viewBox=\"0 0 1000 1000\">"
+        ]
+        if useFanOut > 0 {
+            lines.append("<defs><g id=\"shape\">")
+            for _ in 0..<4 {
+                lines.append(path(&random, center: (0.0, 0.0), radius: 10.0))
+            }
+            lines.append("</g></defs>")
+        }
+
+        var remaining = elementCount
+        while remaining > 0 {
+            let count = min(runLength, remaining)
+            remaining -= count
+            for _ in 0..<nestingDepth {
+                lines.append("<g\(transform(&random))>")
+            }
+            let center = (random.nextDouble(100.0...900.0), random.nextDouble(100.0...900.0))
+            for _ in 0..<count {
+                lines.append(path(&random, center: center, radius: 100.0))
+            }
+            lines.append([String](count: nestingDepth, repeatedValue: "</g>").joinWithSeparator(""))
+        }
+
+        for _ in 0..<useFanOut {
+            let x = random.nextDouble(0.0...1000.0)
+            let y = random.nextDouble(0.0...1000.0)
+            lines.append(String(format: "<use xlink:href=\"#shape\" x=\"%.2f\" y=\"%.2f\"", x, y) + transform(&random) + "/>")
+        }
+        lines.append("</svg>")
+        return lines.joinWithSeparator("\n")
+    }
+
+    var data: NSData {
+        return source.dataUsingEncoding(NSUTF8StringEncoding)!
+    }
+
+    // MARK: -
+
+    private static let colors = ["#1f77b4", "#ff7f0e", "#2ca02c", "#d62728", "#9467bd", "#8c564b", "#e377c2", "#7f7f7f"]
+
+    private func transform(inout random: SeededRandom) -> String {
+        guard random.nextDouble() < transformDensity else {
+            return ""
+        }
+        return String(format: " transform=\"translate(%.2f %.2f) rotate(%.1f)\"",
+                      random.nextDouble(-10.0...10.0), random.nextDouble(-10.0...10.0), random.nextDouble(-5.0...5.0))
+    }
+
+    private func point(inout random: SeededRandom, center: (Double, Double), radius: Double) -> String {
+        return String(format: "%.2f %.2f", center.0 + random.nextDouble(-radius...radius),
+                      center.1 + random.nextDouble(-radius...radius))
+    }
+
+    /// A path of lines and curves wandering around center.
+    private func path(inout random: SeededRandom, center: (Double, Double), radius: Double) -> String {
+        var data = "M " + point(&random, center: center, radius: radius)
+        for _ in 0..<pathLength {
+            let pointCount = random.nextInt(3) + 1
+            data += [" L", " Q", " C"][pointCount - 1]
+            for _ in 0..<pointCount {
+                data += " " + point(&random, center: center, radius: radius)
+            }
+        }
+        data += " Z"
+        let color = SVGSyntheticDocument.colors[random.nextInt(max(1, min(colorCount, SVGSyntheticDocument.colors.count)))]
+        return "<path d=\"\(data)\" fill=\"\(color)\"\(transform(&random))/>"
+    }
+}
+
+/// Times each stage on documents swept along one dimension and reports the
+/// times with each stage's growth exponent, the slope of log time against
+/// log size between the smallest and largest documents. An exponent near 1
+/// is linear and near 2 quadratic.
+struct SVGScalingBenchmark {
+    enum Stage: String {
+        case process
+        case optimise
+        case render
+        case export
+
+        static let allStages: [Stage] = [.process, .optimise, .render, .export]
+    }
+
+    struct Curve {
+        let dimension: String
+        let values: [Double]
+        /// Seconds for each stage at each value.
+        var times = [Stage: [Double]]()
+
+        /// Nil if the sweep starts at zero.
+        func exponent(stage: Stage) -> Double? {
+            guard let times = self.times[stage], let first = values.first, let last = values.last,
+                let firstTime = times.first, let lastTime = times.last
+                where first > 0.0 && last > first && firstTime > 0.0 && lastTime > 0.0 else {
+                return .None
+            }
+            return log(lastTime / firstTime) / log(last / first)
+        }
+
+        var report: String {
+            var lines = [dimension + "\t" + Stage.allStages.map({ $0.rawValue }).joinWithSeparator("\t")]
+            for (index, value) in values.enumerate() {
+                let columns = Stage.allStages.map() { String(format: "%.4f", self.times[$0]?[index] ?? 0.0) }
+                lines.append(String(format: "%g\t", value) + columns.joinWithSeparator("\t"))
+            }
+            let exponents = Stage.allStages.map() { (stage: Stage) -> String in
+                guard let exponent = self.exponent(stage) else {
+                    return "-"
+                }
+                // Flag anything growing clearly faster than linearly.
+                return String(format: exponent > 1.5 ? "%.2f!" : "%.2f", exponent)
+            }
+            lines.append("exponent\t" + exponents.joinWithSeparator("\t"))
+            return lines.joinWithSeparator("\n")
+        }
+    }
+
+    var renderSize = 512
+
+    func measure(dimension: String, values: [Double],
+                 document: (value: Double) -> SVGSyntheticDocument) -> Curve {
+        var curve = Curve(dimension: dimension, values: values, times: [: ])
+        for value in values {
+            let data = document(value: value).data
+            var svgDocument: SVGDocument? = .None
+            record(&curve, stage: .process) {
+                svgDocument = (try? SVGProcessor().processData(data)) ?? .None
+            }
+            guard let processed = svgDocument else {
+                continue
+            }
+
+            record(&curve, stage: .render) {
+                if let context = SVGTiledRenderer.makeBitmapContext(self.renderSize, height: self.renderSize) {
+                    CGContextConcatCTM(context, SVGTiledRenderer.documentTransform(processed,
+                        size: CGSize(width: self.renderSize, height: self.renderSize)))
+                    let _ = try? SVGRenderer().renderDocument(processed, renderer: context)
+                }
+            }
+            record(&curve, stage: .export) {
+                let renderer = MovingImagesRenderer()
+                let _ = try? SVGRenderer().renderDocument(processed, renderer: renderer)
+                let _ = jsonObjectToString(renderer.generateJSONDict())
+            }
+            // Last, as it changes the document.
+            record(&curve, stage: .optimise) {
+                processed.optimise()
+            }
+        }
+        return curve
+    }
+
+    private func record(inout curve: Curve, stage: Stage, @noescape body: () -> Void) {
+        let startTime = CFAbsoluteTimeGetCurrent()
+        body()
+        let elapsed = CFAbsoluteTimeGetCurrent() - startTime
+        curve.times[stage] = (curve.times[stage] ?? []) + [elapsed]
+    }
+}
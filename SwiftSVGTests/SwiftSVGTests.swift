@@ -119,6 +119,469 @@ class SwiftSVGTests: XCTestCase {
         
     }
     
+    func testResolvedGradientIsCached() {
+        guard let xmlDocument = try? xmlDocumentFromNamedSVGFile("paperplane"),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+
+        let group00 = (svgDocument.children[0] as! SVGGroup).children[0] as! SVGGroup
+        let polygon = group00.children[0]
+        guard let svgGradient = polygon.gradientFill, let gradientFill = polygon.linearGradientFill else {
+            XCTAssert(false, "No gradient fill as part of polygon")
+            return
+        }
+        XCTAssert(svgGradient.coalesceLinearGradientInheritance() === svgGradient.coalesceLinearGradientInheritance(),
+            "Gradient inheritance should only be resolved once")
+        XCTAssert(polygon.linearGradientFill === gradientFill, "The gradient fill should be cached on the element")
+        XCTAssert(gradientFill.startPoint! == svgGradient.coalesceLinearGradientInheritance().startPoint!,
+            "Bound start point should match the resolved gradient")
+
+        var messages = [String]()
+        let savedHandler = SVGLog.handler
+        SVGLog.handler = { messages.append($0) }
+        defer {
+            SVGLog.handler = savedHandler
+            SVGLog.level = .off
+        }
+        let context = SVGTiledRenderer.makeBitmapContext(500, height: 260)!
+        try! SVGRenderer().renderDocument(svgDocument, renderer: context)
+        XCTAssert(messages.isEmpty, "Nothing should be logged when logging is off")
+        SVGLog.level = .debug
+        try! SVGRenderer().renderDocument(svgDocument, renderer: context)
+        XCTAssert(!messages.isEmpty, "Gradient rendering should log at the debug level")
+    }
+
+    func testInstrumentation() {
+        guard let url = try? makeURLFromNamedFile("map", fileExtension: "svg"),
+            let data = NSData(contentsOfURL: url) else {
+            XCTAssert(false, "Failed to read map.svg")
+            return
+        }
+        SVGInstrumentation.reset()
+        defer {
+            SVGInstrumentation.enabled = false
+            SVGInstrumentation.reset()
+        }
+        _ = try? SVGProcessor().processData(data)
+        XCTAssert(SVGInstrumentation.snapshot().counters.isEmpty, "Nothing should be recorded when disabled")
+
+        SVGInstrumentation.enabled = true
+        guard let optionalDocument = try? SVGProcessor().processData(data),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        let context = SVGTiledRenderer.makeBitmapContext(200, height: 120)!
+        try! SVGRenderer().renderDocument(svgDocument, renderer: context)
+
+        let snapshot = SVGInstrumentation.snapshot()
+        XCTAssert(snapshot.counters["bytes.in"] == data.length, "Bytes in should be the size of the file")
+        XCTAssert(snapshot.counters(category: "elements")["path"] > 0, "Path elements should be counted")
+        XCTAssert(snapshot.counters(category: "segments")["moveTo"] > 0, "Path segments should be counted by verb")
+        for phase: SVGInstrumentation.Phase in [.xml, .elements, .style, .transforms, .paths, .render] {
+            XCTAssert(snapshot.phaseCalls[phase] > 0, "The \(phase.rawValue) phase should be timed")
+        }
+        XCTAssert(snapshot.phaseCalls[.serialize] == nil, "Nothing was serialized")
+        guard let pathSegments = snapshot.histograms["pathSegments"] else {
+            XCTAssert(false, "Segments per path should be recorded")
+            return
+        }
+        XCTAssert(pathSegments.minimum <= pathSegments.percentile(0.5) &&
+                  pathSegments.percentile(0.5) <= pathSegments.maximum,
+                  "The median should be between the smallest and largest values")
+        XCTAssert(NSJSONSerialization.isValidJSONObject(snapshot.jsonObject), "The snapshot should export as JSON")
+    }
+
+    func testRenderProfiler() {
+        guard let xmlDocument = try? xmlDocumentFromNamedSVGFile("map"),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        let svgRenderer = SVGRenderer()
+        var prerenderCount = 0
+        svgRenderer.callbacks.prerenderElement = { _, _ in
+            prerenderCount += 1
+            return true
+        }
+        let profiler = SVGRenderProfiler()
+        profiler.install(svgRenderer)
+        let renderer = MovingImagesRenderer()
+        try! svgRenderer.renderDocument(svgDocument, renderer: renderer)
+
+        XCTAssert(prerenderCount > 0, "Callbacks set before installing should still be called")
+        let root = profiler.root
+        XCTAssert(root.totalPathSegments > 0, "Path segments should be counted")
+        XCTAssert(root.totalBytes > 0, "Bytes emitted by the renderer should be counted")
+        XCTAssert(root.totalPathSegments == root.children.reduce(0) { $0 + $1.totalPathSegments },
+                  "The document's cost should be the sum of its elements")
+        if let group = root.children.first {
+            XCTAssert(group.totalBytes >= group.children.reduce(0) { $0 + $1.totalBytes },
+                      "A group's cost should include its children")
+        }
+
+        let lines = profiler.foldedStacks(.pathSegments).componentsSeparatedByString("\n")
+        XCTAssert(!lines.isEmpty, "The report should have a line per element")
+        var reportedSegments = 0
+        for line in lines {
+            let fields = line.componentsSeparatedByString(" ")
+            XCTAssert(fields.count == 2 && fields[0].hasPrefix("document;"), "Lines should be a stack and a count")
+            reportedSegments += Int(fields.last ?? "") ?? 0
+        }
+        XCTAssert(reportedSegments == root.totalPathSegments, "The report should account for every segment")
+    }
+
+    func testFontCache() {
+        let fontCache = SVGFontCache()
+        let font = fontCache.font(family: "Helvetica,Arial", size: 24.0)
+        XCTAssert(fontCache.font(family: "Helvetica,Arial", size: 24.0).ctFont === font.ctFont,
+                  "The same family list and size should share one font")
+        XCTAssert(fontCache.font(family: "Helvetica,Arial", size: 12.0).ctFont !== font.ctFont,
+                  "Sizes should have their own fonts")
+        XCTAssert(fontCache.fontCount == 2, "Two fonts should have been resolved")
+
+        let attributes: [NSString : AnyObject] = [ kCTFontAttributeName : font.ctFont ]
+        let line = CTLineCreateWithAttributedString(CFAttributedStringCreate(kCFAllocatorDefault, "Sheffield", attributes))
+        let expectedWidth = CTLineGetBoundsWithOptions(line, CTLineBoundsOptions(rawValue: 0)).width
+        var widths = [CGFloat](count: 64, repeatedValue: 0.0)
+        widths.withUnsafeMutableBufferPointer() {
+            (inout buffer: UnsafeMutableBufferPointer<CGFloat>) -> Void in
+            let widthsPointer = buffer.baseAddress
+            dispatch_apply(64, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0)) { index in
+                widthsPointer[index] = fontCache.stringWidth("Sheffield", family: "Helvetica,Arial", size: 24.0)
+            }
+        }
+        XCTAssert(!widths.contains({ $0 != expectedWidth }), "Cached widths should match measuring the line")
+        XCTAssert(fontCache.widthCount == 1, "Each string should be measured once per font")
+
+        fontCache.removeAll()
+        XCTAssert(fontCache.fontCount == 0 && fontCache.widthCount == 0, "The cache should be empty")
+    }
+
+    func testGradientRamp() {
+        let colorSpace = CGColorSpaceCreateWithName(kCGColorSpaceSRGB)
+        let black = CGColorCreate(colorSpace, [0.0, 0.0, 0.0, 1.0])!
+        let white = CGColorCreate(colorSpace, [1.0, 1.0, 1.0, 1.0])!
+        let stops = [
+            SVGGradientStop(offset: 0.0, opacity: 1.0, color: black),
+            SVGGradientStop(offset: 1.0, opacity: 1.0, color: white)
+        ]
+
+        guard let padRamp = SVGGradientRamp(stops: stops, spreadMethod: .pad) else {
+            XCTAssert(false, "Failed to create a gradient ramp")
+            return
+        }
+        XCTAssert(padRamp.pixels.count == SVGGradientRamp.defaultSize, "Ramp should have the default number of entries")
+        let opaqueBlack = UInt32(littleEndian: 0xFF000000)
+        let opaqueWhite = UInt32(0xFFFFFFFF)
+        let opaqueGray = padRamp.pixels[128]
+        XCTAssert(padRamp.pixels[0] == opaqueBlack, "First ramp entry should be opaque black")
+        XCTAssert(padRamp.pixels[255] == opaqueWhite, "Last ramp entry should be opaque white")
+
+        var span = [UInt32](count: 5, repeatedValue: 0)
+        padRamp.fillLinearSpan(&span, count: 5, t0: -1.0, dt: 1.0)
+        XCTAssert(span == [opaqueBlack, opaqueBlack, opaqueWhite, opaqueWhite, opaqueWhite], "Pad should clamp to the end colors")
+
+        let repeatRamp = SVGGradientRamp(stops: stops, spreadMethod: .`repeat`)!
+        repeatRamp.fillLinearSpan(&span, count: 5, t0: 0.0, dt: 0.5)
+        XCTAssert(span == [opaqueBlack, opaqueGray, opaqueBlack, opaqueGray, opaqueBlack], "Repeat should restart the ramp")
+
+        let reflectRamp = SVGGradientRamp(stops: stops, spreadMethod: .reflect)!
+        reflectRamp.fillLinearSpan(&span, count: 5, t0: 0.0, dt: 0.5)
+        XCTAssert(span == [opaqueBlack, opaqueGray, opaqueWhite, opaqueGray, opaqueBlack], "Reflect should mirror the ramp")
+
+        // Concentric circles, the focal point at the center.
+        reflectRamp.fillRadialSpan(&span, count: 5, point: CGPoint(x: 0.0, y: 0.0), step: CGVector(dx: 5.0, dy: 0.0),
+                                   center: CGPoint(x: 0.0, y: 0.0), radius: 10.0)
+        XCTAssert(span == [opaqueBlack, opaqueGray, opaqueWhite, opaqueGray, opaqueBlack], "Radial reflect should mirror the ramp")
+    }
+
+    func testTextOutlines() {
+        // Arial moved into Supplemental in macOS 10.15.
+        let fontURLs = ["/Library/Fonts/Arial.ttf", "/System/Library/Fonts/Supplemental/Arial.ttf"].map() {
+            NSURL(fileURLWithPath: $0)
+        }
+        guard let fontURL = fontURLs.filter({ $0.checkResourceIsReachableAndReturnError(nil) }).first,
+            let textOutliner = try? SVGTextOutliner(fontURL: fontURL) else {
+            XCTFail("Arial.ttf is needed to test outlining text")
+            return
+        }
+        let origin = CGPoint(x: 20.0, y: 200.0)
+        let geometry = textOutliner.geometry("Fill and stroke", fontFamily: "Arial", size: 40.0, origin: origin)
+        XCTAssert(!geometry.verbs.isEmpty, "Text should have an outline")
+        XCTAssert(geometry.bounds.maxY <= origin.y + 10.0 && geometry.bounds.minY < origin.y - 20.0,
+                  "Letters should be above the baseline in y down space")
+        XCTAssert(geometry.bounds.minX >= origin.x, "The outline should start at the origin")
+
+        let glyphOutlineCount = textOutliner.glyphOutlineCount
+        XCTAssert(glyphOutlineCount <= Set("Fill and stroke".characters).count, "Each glyph should be outlined once")
+        let repeated = textOutliner.geometry("Fill and stroke", fontFamily: "Arial", size: 40.0, origin: CGPoint.zero)
+        XCTAssert(textOutliner.shapedRunCount == 1, "A repeated string should only be shaped once")
+        XCTAssert(textOutliner.glyphOutlineCount == glyphOutlineCount, "Repeated glyphs should come from the cache")
+        XCTAssert(repeated.verbs == geometry.verbs, "A repeated string should have the same outline")
+        let substituted = textOutliner.geometry("\u{65E5}\u{672C}", fontFamily: "Arial", size: 40.0, origin: origin)
+        XCTAssert(!substituted.verbs.isEmpty, "Characters Arial doesn't have should be outlined from a substitute font")
+
+        guard let xmlDocument = try? xmlDocumentFromNamedSVGFile("TextDrawing"),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        let displayList = try! svgDocument.displayList()
+        XCTAssert(displayList.commands.contains({ if case .drawText = $0 { return true }; return false }),
+                  "The document should draw text")
+        let outlines = try! SVGDisplayList(svgDocument: svgDocument, textOutliner: textOutliner)
+        XCTAssert(!outlines.commands.contains({ if case .drawText = $0 { return true }; return false }),
+                  "Outlined text should be drawn as paths")
+        XCTAssert(outlines.commands.contains({ if case .addPath = $0 { return true }; return false }),
+                  "Outlined text should be drawn as paths")
+    }
+
+    func testStroker() {
+        let line = CGPathCreateMutable()
+        CGPathMoveToPoint(line, nil, 0.0, 0.0)
+        CGPathAddLineToPoint(line, nil, 10.0, 0.0)
+        var style = SVGStrokeStyle()
+        style.lineWidth = 2.0
+
+        let stroker = SVGStroker()
+        let outline = stroker.strokedPath(line, style: style)
+        XCTAssert(CGRectEqualToRect(CGPathGetPathBoundingBox(outline), CGRect(x: 0.0, y: -1.0, width: 10.0, height: 2.0)),
+                  "A butt capped line should be outlined by a rectangle")
+        style.lineCap = .Square
+        XCTAssert(CGRectEqualToRect(CGPathGetPathBoundingBox(stroker.strokedPath(line, style: style)),
+                                    CGRect(x: -1.0, y: -1.0, width: 12.0, height: 2.0)),
+                  "Square caps should extend the line by half the width")
+
+        stroker.strokedPath(line, style: style)
+        XCTAssert(stroker.hitCount == 1 && stroker.missCount == 2, "The same path and style should be outlined once")
+        stroker.strokedPath(line, style: style, scale: 4.0)
+        XCTAssert(stroker.missCount == 3, "Each scale should have its own outline")
+
+        style.lineCap = .Butt
+        style.lineDash = [2.0]
+        let dashed = SVGPathGeometry(path: stroker.strokedPath(line, style: style))
+        XCTAssert(dashed.verbs.filter({ $0 == .moveTo }).count == 3, "An odd dash list should be repeated")
+
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" viewBox=\"0 0 100 100\">" +
+            "<line x1=\"10\" y1=\"50\" x2=\"90\" y2=\"50\" stroke=\"red\" stroke-width=\"20\" " +
+            "stroke-dasharray=\"20 20\"/></svg>"
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument,
+            let context = SVGTiledRenderer.makeBitmapContext(100, height: 100) else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        CGContextConcatCTM(context, SVGTiledRenderer.documentTransform(svgDocument, size: CGSize(width: 100, height: 100)))
+        let svgRenderer = SVGRenderer()
+        svgRenderer.stroker = SVGStroker()
+        try! svgRenderer.renderDocument(svgDocument, renderer: context)
+        let bytes = UnsafePointer<UInt8>(CGBitmapContextGetData(context))
+        let bytesPerRow = CGBitmapContextGetBytesPerRow(context)
+        func red(x: Int, _ y: Int) -> UInt8 {
+            return bytes[y * bytesPerRow + x * 4]
+        }
+        XCTAssert(red(20, 50) > 250 && red(20, 42) > 250, "Dashes should be filled to the stroke width")
+        XCTAssert(red(40, 50) == 0, "Gaps between dashes should be empty")
+        XCTAssert(red(20, 30) == 0, "Nothing should be drawn outside the stroke")
+
+        // The tiled renderer outlines strokes at the scale it draws at.
+        let tiledRenderer = SVGTiledRenderer()
+        tiledRenderer.stroker = SVGStroker()
+        let size = CGSize(width: 200, height: 200)
+        guard let tiled = try? tiledRenderer.renderDocument(svgDocument, size: size),
+            let untiled = try? SVGTiledRenderer.renderDocumentUntiled(svgDocument, size: size,
+                                                                      stroker: tiledRenderer.stroker) else {
+            XCTAssert(false, "Failed to render the document")
+            return
+        }
+        XCTAssert(tiledRenderer.stroker!.hitCount > 0, "Both renders should outline at the same scale")
+        XCTAssert(tiled != nil && untiled != nil, "The document should be rendered with outlined strokes")
+    }
+
+    func testLevelOfDetail() {
+        // A line 400 units long with a zigzag of 0.2 units.
+        let zigzag = CGPathCreateMutable()
+        CGPathMoveToPoint(zigzag, nil, 0.0, 0.0)
+        for x in 1...400 {
+            CGPathAddLineToPoint(zigzag, nil, CGFloat(x), x % 2 == 0 ? 0.0 : 0.2)
+        }
+        let path = SVGOutlinePath(path: zigzag)
+        let levelOfDetail = SVGLevelOfDetail()
+
+        let fullSize = levelOfDetail.pathGenerator(path, transform: CGAffineTransformIdentity)
+        XCTAssert(fullSize?.path.cgpath === zigzag, "A path drawn at full size should be drawn as it is")
+        XCTAssert(levelOfDetail.count == 0, "No levels should be built for a path drawn at full size")
+        let rotated = CGAffineTransformRotate(CGAffineTransformMakeScale(0.1, 0.1), 1.0)
+        if let tenth = levelOfDetail.pathGenerator(path, transform: rotated) {
+            XCTAssert(SVGPathGeometry(path: tenth.path.cgpath).points.count == 2,
+                      "At a tenth of the size the zigzag should be drawn as a line")
+        }
+        else {
+            XCTAssert(false, "A path 40 pixels long should be drawn")
+        }
+        XCTAssert(levelOfDetail.count == 1, "Levels should be kept once per path")
+
+        let tiny = CGAffineTransformMakeScale(0.001, 0.001)
+        if let dot = levelOfDetail.pathGenerator(path, transform: tiny) {
+            let bounds = CGPathGetPathBoundingBox(dot.path.cgpath)
+            XCTAssert(dot.isDot, "The dot should be filled")
+            XCTAssert(abs(bounds.width - 1000.0) < 0.001 && abs(bounds.midX - 200.0) < 0.001,
+                      "A path smaller than a pixel should be drawn as a one pixel dot at its center")
+        }
+        else {
+            XCTAssert(false, "A path smaller than a pixel should be drawn as a dot")
+        }
+        levelOfDetail.drawsSmallPathsAsDots = false
+        XCTAssert(levelOfDetail.pathGenerator(path, transform: tiny) == nil,
+                  "A path smaller than a pixel should be skipped")
+
+        guard let xmlDocument = try? xmlDocumentFromNamedSVGFile("map"),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument,
+            let displayList = try? svgDocument.displayList(),
+            let context = SVGTiledRenderer.makeBitmapContext(107, height: 63) else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        levelOfDetail.removeAll()
+        levelOfDetail.prepare(displayList)
+        XCTAssert(levelOfDetail.count > 0, "Levels should be built for the paths of the map")
+        let transform = SVGTiledRenderer.documentTransform(svgDocument, size: CGSize(width: 107, height: 63))
+        CGContextConcatCTM(context, transform)
+        try! displayList.replay(context, levelOfDetail: levelOfDetail, deviceTransform: CGContextGetCTM(context))
+
+        // A stroked path smaller than a pixel is filled as a one pixel dot,
+        // not stroked, which would make it as wide as the line.
+        let strokedSource = "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" viewBox=\"0 0 1000 1000\">" +
+            "<path d=\"M 500 500 L 501 501\" fill=\"none\" stroke=\"rgb(255,0,0)\" stroke-width=\"500\"/></svg>"
+        guard let strokedXMLDocument = try? NSXMLDocument(XMLString: strokedSource, options: 0),
+            let optionalStrokedDocument = try? SVGProcessor().processXMLDocument(strokedXMLDocument),
+            let strokedDocument = optionalStrokedDocument,
+            let strokedDisplayList = try? strokedDocument.displayList(),
+            let dotContext = SVGTiledRenderer.makeBitmapContext(10, height: 10) else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        CGContextConcatCTM(dotContext, SVGTiledRenderer.documentTransform(strokedDocument, size: CGSize(width: 10, height: 10)))
+        try! strokedDisplayList.replay(dotContext, levelOfDetail: SVGLevelOfDetail(),
+                                       deviceTransform: CGContextGetCTM(dotContext))
+        let bytes = UnsafeMutablePointer<UInt8>(CGBitmapContextGetData(dotContext))
+        let bytesPerRow = CGBitmapContextGetBytesPerRow(dotContext)
+        var coveredCount = 0
+        for y in 0..<10 {
+            for x in 0..<10 where bytes[y * bytesPerRow + x * 4 + 3] > 0 {
+                coveredCount += 1
+            }
+        }
+        XCTAssert(coveredCount > 0 && coveredCount <= 4, "The dot should cover about one pixel, not \(coveredCount)")
+        XCTAssert(bytes[5 * bytesPerRow + 5 * 4] > 0 || bytes[4 * bytesPerRow + 4 * 4] > 0,
+                  "The dot should be drawn in the stroke color")
+    }
+
+    func testRadialGradient() {
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" " +
+            "version=\"1.1\" viewBox=\"0 0 100 100\"><defs>" +
+            "<linearGradient id=\"stops\"><stop offset=\"0\" stop-color=\"red\"/><stop offset=\"1\" stop-color=\"blue\"/></linearGradient>" +
+            "<radialGradient id=\"radial\" xlink:href=\"#stops\" r=\"0.25\" spreadMethod=\"reflect\"/>" +
+            "</defs><rect x=\"0\" y=\"0\" width=\"100\" height=\"100\" fill=\"url(#radial)\"/></svg>"
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+
+        guard let rect = svgDocument.children.last, let gradientFill = rect.radialGradientFill else {
+            XCTAssert(false, "Rect should have a radial gradient fill")
+            return
+        }
+        XCTAssert(gradientFill.spreadMethod == .reflect, "Spread method should be reflect")
+        XCTAssert(gradientFill.gradient.stops?.count == 2, "Stops should be inherited from the linear gradient")
+        XCTAssert(gradientFill.centerPoint == CGPoint(x: 0.5, y: 0.5), "Center should default to 50%")
+        XCTAssert(gradientFill.focalPoint == gradientFill.centerPoint, "Focal point should default to the center")
+        XCTAssert(gradientFill.radius == 0.25, "Radius should be 0.25")
+
+        guard let optionalImage = try? SVGTiledRenderer.renderDocumentUntiled(svgDocument, size: CGSize(width: 100, height: 100)),
+            let image = optionalImage,
+            let data = CGDataProviderCopyData(CGImageGetDataProvider(image)) else {
+            XCTAssert(false, "Rendering should produce an image")
+            return
+        }
+        let bytes = UnsafePointer<UInt8>(CFDataGetBytePtr(data))
+        let bytesPerRow = CGImageGetBytesPerRow(image)
+        func pixel(x: Int, _ y: Int) -> (red: UInt8, blue: UInt8) {
+            let offset = y * bytesPerRow + x * 4
+            return (bytes[offset], bytes[offset + 2])
+        }
+        // The ramp runs red to blue out to a radius of 25 and reflects back to red at 50.
+        XCTAssert(pixel(50, 50).red > 200 && pixel(50, 50).blue < 55, "Center should be red")
+        XCTAssert(pixel(75, 50).blue > 200 && pixel(75, 50).red < 55, "Radius 25 should be blue")
+        XCTAssert(pixel(99, 50).red > 200 && pixel(99, 50).blue < 55, "Radius 50 should have reflected back to red")
+
+        let renderer = MovingImagesRenderer()
+        try! SVGRenderer().renderDocument(svgDocument, renderer: renderer)
+        XCTAssert(renderer.render().containsString("radialgradientfill"), "JSON should contain a radial gradient fill")
+    }
+
+    func testRadialGradientUserSpaceDefaults() {
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" viewBox=\"0 0 200 100\"><defs>" +
+            "<radialGradient id=\"radial\" gradientUnits=\"userSpaceOnUse\"><stop offset=\"0\" stop-color=\"red\"/>" +
+            "<stop offset=\"1\" stop-color=\"blue\"/></radialGradient>" +
+            "</defs><rect x=\"0\" y=\"0\" width=\"200\" height=\"100\" fill=\"url(#radial)\"/></svg>"
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument,
+            let rect = svgDocument.children.last,
+            let gradientFill = rect.radialGradientFill else {
+            XCTAssert(false, "Rect should have a radial gradient fill")
+            return
+        }
+        XCTAssert(gradientFill.centerPoint == CGPoint(x: 100, y: 50), "Center should default to 50% of the viewport")
+        XCTAssert(gradientFill.focalPoint == gradientFill.centerPoint, "Focal point should default to the center")
+        XCTAssert(abs(gradientFill.radius - 0.5 * sqrt(0.5 * (200 * 200 + 100 * 100))) < 1.0e-9,
+                  "Radius should default to 50% of the viewport's normalized diagonal")
+
+        guard let optionalImage = try? SVGTiledRenderer.renderDocumentUntiled(svgDocument, size: CGSize(width: 200, height: 100)),
+            let image = optionalImage,
+            let data = CGDataProviderCopyData(CGImageGetDataProvider(image)) else {
+            XCTAssert(false, "Rendering should produce an image")
+            return
+        }
+        let bytes = UnsafePointer<UInt8>(CFDataGetBytePtr(data))
+        let center = 50 * CGImageGetBytesPerRow(image) + 100 * 4
+        XCTAssert(bytes[center] > 200 && bytes[center + 2] < 55, "The middle of the viewport should be red")
+    }
+
+    func testRadialGradientInheritanceAndTransform() {
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" " +
+            "version=\"1.1\" viewBox=\"0 0 100 100\"><defs>" +
+            "<radialGradient id=\"base\" fx=\"0.25\" r=\"0.5\"><stop offset=\"0\" stop-color=\"red\"/>" +
+            "<stop offset=\"1\" stop-color=\"blue\"/></radialGradient>" +
+            "<radialGradient id=\"derived\" xlink:href=\"#base\" cx=\"0.6\" gradientTransform=\"translate(0.1 0)\"/>" +
+            "</defs><rect x=\"0\" y=\"0\" width=\"100\" height=\"100\" fill=\"url(#derived)\"/></svg>"
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument,
+            let rect = svgDocument.children.last,
+            let gradientFill = rect.radialGradientFill else {
+            XCTAssert(false, "Rect should have a radial gradient fill")
+            return
+        }
+        XCTAssert(gradientFill.centerPoint == CGPoint(x: 0.6, y: 0.5), "cx should override and cy default to 50%")
+        XCTAssert(gradientFill.focalPoint == CGPoint(x: 0.25, y: 0.5),
+                  "fx should be inherited and fy default to the resolved center")
+        let origin = CGPointApplyAffineTransform(CGPoint.zero, gradientFill.gradientTransform)
+        XCTAssert(abs(origin.x - 10.0) < 1.0e-9 && abs(origin.y) < 1.0e-9,
+                  "gradientTransform should apply in bounding box units")
+    }
+
     func testSimpleText() {
         var optionalSVGDocument: SVGDocument?
         do {
@@ -236,7 +699,891 @@ class SwiftSVGTests: XCTestCase {
             return $0 is SVGPath
         }
         XCTAssert(paths.count == 3603, "map.svg group0 should have 3603 child paths.")
-        
+
+    }
+
+    func testMappedFileLoading() {
+        guard let url = try? makeURLFromNamedFile("map", fileExtension: "svg"),
+            let optionalDocument = try? SVGProcessor().processFileURL(url),
+            let svgDocument = optionalDocument,
+            let group0 = svgDocument.children[0] as? SVGGroup else {
+            XCTAssert(false, "Failed to create SVGDocument from the mapped file")
+            return
+        }
+        XCTAssert(group0.children.count == 5191, "The mapped map.svg group0 should have 5191 children.")
+        XCTAssert(group0.children.filter({ $0 is SVGPath }).count == 3603, "The mapped map.svg should have 3603 paths.")
+    }
+
+    /// A synthetic document of several megabytes in a temporary file, for
+    /// comparing loading it mapped with loading it as a string.
+    private func writeLargeDocument() -> (url: NSURL, document: SVGSyntheticDocument)? {
+        var document = SVGSyntheticDocument()
+        document.elementCount = 8000
+        document.pathLength = 16
+        let url = NSURL(fileURLWithPath: NSTemporaryDirectory()).URLByAppendingPathComponent("SwiftSVGTestsLarge.svg")
+        let data = document.data
+        guard data.length > 2000000 && data.writeToURL(url, atomically: true) else {
+            return .None
+        }
+        return (url: url, document: document)
+    }
+
+    func testMappedLoadingOfLargeFile() {
+        guard let large = writeLargeDocument() else {
+            XCTAssert(false, "Failed to write the large document")
+            return
+        }
+        let (url, document) = large
+        defer {
+            let _ = try? NSFileManager.defaultManager().removeItemAtURL(url)
+        }
+        measureBlock() {
+            guard let optionalDocument = try? SVGProcessor().processFileURL(url),
+                let svgDocument = optionalDocument else {
+                XCTAssert(false, "Failed to create SVGDocument from the mapped file")
+                return
+            }
+            var pathCount = 0
+            SVGElement.walker.walk(svgDocument) {
+                (element: SVGElement, depth: Int) -> Void in
+                pathCount += element is SVGPath ? 1 : 0
+            }
+            XCTAssert(pathCount == document.elementCount, "Every path in the mapped file should be processed")
+        }
+    }
+
+    /// The baseline for testMappedLoadingOfLargeFile, reading the file into
+    /// a string first as the document window does.
+    func testStringLoadingOfLargeFile() {
+        guard let large = writeLargeDocument() else {
+            XCTAssert(false, "Failed to write the large document")
+            return
+        }
+        let (url, document) = large
+        defer {
+            let _ = try? NSFileManager.defaultManager().removeItemAtURL(url)
+        }
+        measureBlock() {
+            guard let source = try? String(contentsOfURL: url, encoding: NSUTF8StringEncoding),
+                let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+                let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+                let svgDocument = optionalDocument else {
+                XCTAssert(false, "Failed to create SVGDocument from the string")
+                return
+            }
+            var pathCount = 0
+            SVGElement.walker.walk(svgDocument) {
+                (element: SVGElement, depth: Int) -> Void in
+                pathCount += element is SVGPath ? 1 : 0
+            }
+            XCTAssert(pathCount == document.elementCount, "Every path in the string should be processed")
+        }
+    }
+
+    func testCompactDocument() {
+        guard let xmlDocument = try? xmlDocumentFromNamedSVGFile("map"),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+
+        let compactDocument = SVGCompactDocument(svgDocument: svgDocument)
+        let statistics = svgDocument.elementAllocationStatistics()
+        XCTAssert(compactDocument.nodes.count == statistics.elementCount,
+                  "The compact document should have a node for every element")
+        let group0 = compactDocument.childIndices(compactDocument.rootIndex)[0]
+        let children = compactDocument.childIndices(group0)
+        XCTAssert(children.count == 5191, "map.svg group0 should have 5191 children.")
+        XCTAssert(children.filter({ compactDocument.nodes[$0].kind == .path }).count == 3603,
+                  "map.svg group0 should have 3603 child paths.")
+        XCTAssert(!children.contains({ compactDocument.nodes[$0].parent != Int32(group0) }),
+                  "Every child should link back to group0")
+
+        let objectBytesPerElement = Double(statistics.byteCount) / Double(statistics.elementCount)
+        XCTAssert(compactDocument.bytesPerElement < objectBytesPerElement,
+                  "The compact document should use less memory per element: " +
+                  "\(compactDocument.bytesPerElement) vs \(objectBytesPerElement)")
+        XCTAssert(compactDocument.byteCount > compactDocument.nodes.count * strideof(SVGCompactNode),
+                  "The paths the compact document refers to should be counted")
+
+        // Drawing the compact document should look like drawing the elements.
+        let size = CGSize(width: 400, height: 200)
+        let transform = SVGTiledRenderer.documentTransform(viewBox: compactDocument.viewBox, size: size)
+        let direct = SVGTiledRenderer.makeBitmapContext(Int(size.width), height: Int(size.height))!
+        CGContextConcatCTM(direct, transform)
+        try! SVGRenderer().renderDocument(svgDocument, renderer: direct)
+        let compact = SVGTiledRenderer.makeBitmapContext(Int(size.width), height: Int(size.height))!
+        CGContextConcatCTM(compact, transform)
+        try! SVGRenderer().renderCompactDocument(compactDocument, renderer: compact)
+        let directBytes = UnsafePointer<UInt8>(CGBitmapContextGetData(direct))
+        let compactBytes = UnsafePointer<UInt8>(CGBitmapContextGetData(compact))
+        var differingBytes = 0
+        for index in 0..<CGBitmapContextGetBytesPerRow(direct) * CGBitmapContextGetHeight(direct)
+            where directBytes[index] != compactBytes[index] {
+            differingBytes += 1
+        }
+        XCTAssert(differingBytes == 0, "The compact document should draw like the elements it was made from")
+    }
+
+    func testCompactDocumentInheritance() {
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" " +
+            "version=\"1.1\" viewBox=\"0 0 30 10\">" +
+            "<defs><rect id=\"r\" width=\"10\" height=\"10\"/></defs>" +
+            "<g fill=\"red\"><rect x=\"10\" width=\"10\" height=\"10\"/></g>" +
+            "<use xlink:href=\"#r\" fill=\"blue\"/>" +
+            "<rect x=\"20\" width=\"10\" height=\"10\" fill=\"none\" stroke=\"green\"/></svg>"
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+
+        let compactDocument = SVGCompactDocument(svgDocument: svgDocument)
+        let context = SVGTiledRenderer.makeBitmapContext(30, height: 10)!
+        CGContextConcatCTM(context, SVGTiledRenderer.documentTransform(viewBox: compactDocument.viewBox,
+                                                                       size: CGSize(width: 30, height: 10)))
+        try! SVGRenderer().renderCompactDocument(compactDocument, renderer: context)
+        let bytes = UnsafePointer<UInt8>(CGBitmapContextGetData(context))
+        let bytesPerRow = CGBitmapContextGetBytesPerRow(context)
+        // Whether each channel of the pixel is nearly full or empty.
+        func pixel(x: Int, _ y: Int) -> [Bool] {
+            return (0..<4).map() { bytes[y * bytesPerRow + x * 4 + $0] > 128 }
+        }
+        XCTAssert(pixel(5, 5) == [false, false, true, true], "The referenced rect should inherit the use element's fill")
+        XCTAssert(pixel(15, 5) == [true, false, false, true], "The rect should inherit its group's fill")
+        XCTAssert(pixel(25, 5) == [false, false, false, false], "A rect with no fill should only be stroked")
+    }
+
+    func testIncrementalProcessing() {
+        func svgSource(radius: Int) -> String {
+            return "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" viewBox=\"0 0 100 100\">" +
+                "<defs><linearGradient id=\"grad\"><stop offset=\"0\" stop-color=\"red\"/></linearGradient></defs>" +
+                "<g><rect x=\"0\" y=\"0\" width=\"10\" height=\"10\"/><circle cx=\"5\" cy=\"5\" r=\"\(radius)\"/></g>" +
+                "<path id=\"p\" d=\"M0 0L10 10\"/>" +
+                "<rect x=\"20\" y=\"0\" width=\"5\" height=\"5\" fill=\"url(#grad)\"/></svg>"
+        }
+        let processor = SVGProcessor()
+        processor.incremental = true
+        func process(source: String) -> SVGDocument? {
+            guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+                let optionalDocument = try? processor.processXMLDocument(xmlDocument) else {
+                return .None
+            }
+            return optionalDocument
+        }
+        guard let first = process(svgSource(2)) else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        let firstElements = first.children
+        let firstGroupChildren = (firstElements[0] as! SVGGroup).children
+        SVGInstrumentation.reset()
+        SVGInstrumentation.enabled = true
+        defer {
+            SVGInstrumentation.enabled = false
+            SVGInstrumentation.reset()
+        }
+        guard let second = process(svgSource(3)) else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+
+        let secondGroup = second.children[0] as! SVGGroup
+        XCTAssert(firstElements[0] !== secondGroup, "The changed group should be processed again")
+        XCTAssert(firstGroupChildren[0] === secondGroup.children[0], "The unchanged rect should be reused")
+        XCTAssert(firstGroupChildren[1] !== secondGroup.children[1], "The changed circle should be processed again")
+        XCTAssert(secondGroup.children[0].parent === secondGroup, "A reused element should belong to the new group")
+        XCTAssert(firstElements[1] === second.children[1], "The unchanged path should be reused")
+        XCTAssert(second.children[1].id == "p", "The reused path should keep its id")
+        XCTAssert(firstElements[2] !== second.children[2], "An element with a url reference should not be reused")
+        XCTAssert(first.isInvalidated && first.children.isEmpty, "The previous document should be invalidated")
+        XCTAssert(!second.isInvalidated, "The new document should be usable")
+        XCTAssert(processor.reusedElementCount == 2, "The rect and the path should be reused")
+        XCTAssert(processor.reuseTimeSaved > 0.0, "The time reuse saved should be reported")
+        let elementCounters = SVGInstrumentation.snapshot().counters("elements")
+        XCTAssert(elementCounters["rect"] == 2 && elementCounters["path"] == 1,
+                  "Reused elements should be counted as processed")
+        XCTAssert(SVGInstrumentation.snapshot().counters("reuse")["elements"] == 2, "Reused elements should be counted")
+
+        second.children[2].display = false
+        guard let third = process(svgSource(3)) else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        XCTAssert(third.children[1] !== second.children[1], "Nothing should be reused from a changed document")
+    }
+
+    func testIdenticalPathsShareGeometry() {
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" viewBox=\"0 0 100 100\">" +
+            "<path d=\"M 0 0 L 10 0 L 10 10 Z\"/>" +
+            "<path d=\"M0 0 L10,0  L10 10Z\" fill=\"red\"/>" +
+            "<path d=\"M 0 0 L 10 0 L 10 10 Z\" transform=\"translate(20 0)\"/>" +
+            "<path d=\"M 0 0 L 20 0 L 20 20 Z\"/></svg>"
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument,
+            let store = svgDocument.geometryStore else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+
+        let paths = svgDocument.children.flatMap() { $0 as? SVGPath }
+        XCTAssert(paths.count == 4, "Every path should be processed")
+        XCTAssert(paths[0].cgpath === paths[1].cgpath && paths[0].cgpath === paths[2].cgpath,
+                  "Paths with the same data should share one CGPath")
+        XCTAssert(paths[0].svgpath == paths[1].svgpath, "Paths with the same data should share one string")
+        XCTAssert(paths[0].cgpath !== paths[3].cgpath, "Different path data should be parsed separately")
+        XCTAssert(store.count == 2 && store.hitCount == 2, "Only distinct path data should be parsed")
+        let minified = SVGGeometryStore()
+        XCTAssert(minified.source("M 0.5 .5 L 1 -2 1e-5 .3") === minified.source("M0.5.5L1-2 1e-5.3"),
+                  "Separators a path doesn't need should be ignored")
+        XCTAssert(minified.source("M 1 .5") !== minified.source("M1.5"), "Separators a path needs should be kept")
+
+        let renderer = MovingImagesRenderer()
+        renderer.sharesPaths = true
+        try! SVGRenderer().renderDocument(svgDocument, renderer: renderer)
+        let json = renderer.generateJSONDict()
+        XCTAssert((json[MIJSONKeySVGPaths] as? [String])?.count == 2, "Each distinct path should be written once")
+        let elements = json[MIJSONKeyArrayOfElements] as? [[NSString : AnyObject]] ?? []
+        let indexes = elements.flatMap() { $0[MIJSONKeySVGPathIndex] as? Int }
+        XCTAssert(indexes == [0, 0, 0, 1], "Elements should refer to their shared path by index")
+        XCTAssert(!elements.contains() { $0[MIJSONKeySVGPath] != nil }, "Shared paths shouldn't be written inline")
+    }
+
+    func testPathGeometryIsBuiltOnFirstUse() {
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" viewBox=\"0 0 100 100\">" +
+            "<path d=\"M 0 0 L 10 0 L 10 10 Z\"/><path d=\"M 0 0 L 10 0 L 10 10 Z\"/>" +
+            "<path d=\"M 20 20 C 30 20 40 30 40 40 Z\"/></svg>"
+        SVGInstrumentation.reset()
+        SVGInstrumentation.enabled = true
+        defer {
+            SVGInstrumentation.enabled = false
+            SVGInstrumentation.reset()
+        }
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        let paths = svgDocument.children.flatMap() { $0 as? SVGPath }
+        XCTAssert(!paths.contains() { $0.source.isMaterialized }, "Processing shouldn't build any CGPaths")
+
+        let renderer = MovingImagesRenderer()
+        try! SVGRenderer().renderDocument(svgDocument, renderer: renderer)
+        XCTAssert(!paths.contains() { $0.source.isMaterialized }, "Exporting to MovingImages shouldn't build any CGPaths")
+        XCTAssert(SVGInstrumentation.snapshot().counters(category: "materialized").isEmpty,
+                  "Nothing should be counted as built")
+
+        let context = SVGTiledRenderer.makeBitmapContext(100, height: 100)!
+        try! SVGRenderer().renderDocument(svgDocument, renderer: context)
+        XCTAssert(!paths.contains() { !$0.source.isMaterialized }, "Drawing should build the CGPaths")
+        let materialized = SVGInstrumentation.snapshot().counters(category: "materialized")
+        let cgpathCount = materialized.reduce(0) { $1.0.hasPrefix("cgpath.") ? $0 + $1.1 : $0 }
+        XCTAssert(cgpathCount == 2, "Each distinct path should be built once")
+        XCTAssert(materialized.keys.contains() { $0.hasPrefix("cgpath.") && $0 != "cgpath.none" },
+                  "Building should be attributed to the renderer")
+
+        XCTAssert(paths[2].bounds == CGRect(x: 20, y: 20, width: 20, height: 20), "Bounds should come from the geometry")
+        XCTAssert(SVGInstrumentation.snapshot().counters(category: "materialized")["geometry.none"] == 1,
+                  "The compact geometry should be built when first measured")
+
+        XCTAssert(SVGInstrumentation.snapshot().counters(category: "materialized")["polyline.none"] == nil,
+                  "Nothing so far should need the polyline")
+        let polyline = paths[2].source.polyline
+        XCTAssert(!polyline.verbs.contains(.quadCurveTo) && !polyline.verbs.contains(.curveTo),
+                  "The polyline should have no curves")
+        XCTAssert(polyline.verbs.count > paths[2].source.geometry.verbs.count, "The curve should become several lines")
+        XCTAssert(polyline.bounds == CGRect(x: 20, y: 20, width: 20, height: 20), "The lines should end on the curve")
+        XCTAssert(paths[2].source.polyline === polyline, "The polyline should be built once")
+        XCTAssert(SVGInstrumentation.snapshot().counters(category: "materialized")["polyline.none"] == 1,
+                  "The polyline should be counted when first built")
+    }
+
+    func testNumberScanner() {
+        let numbers = SVGNumberScanner.scan(" 10,20 30\n-.5 1e3,+2.5E-1 ") { $0.scanNumberList() }
+        XCTAssert(numbers! == [10, 20, 30, -0.5, 1000, 0.25], "Should read \(numbers)")
+        XCTAssert(SVGNumberScanner.scan("10 20 x") { $0.scanNumberList() } == nil, "A list with text should fail")
+
+        SVGNumberScanner.scan("1em") {
+            (inout scanner: SVGNumberScanner) -> Void in
+            XCTAssert(scanner.scanNumber() == 1.0, "The e of a unit is not an exponent")
+            XCTAssert(scanner.scanRemainder() == "em", "The unit should be left to read")
+        }
+        SVGNumberScanner.scan("0.1 123456789012345678901234") {
+            (inout scanner: SVGNumberScanner) -> Void in
+            XCTAssert(scanner.scanNumber() == 0.1, "Should read 0.1 exactly as strtod does")
+            scanner.skipSeparator()
+            XCTAssert(scanner.scanNumber() == strtod("123456789012345678901234", nil),
+                      "Long numbers should read as strtod does")
+        }
+    }
+
+    func testUseElementsAreInstanced() {
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" " +
+            "version=\"1.1\" viewBox=\"0 0 100 50\"><defs>" +
+            "<symbol id=\"square\"><path d=\"M 0 0 L 40 0 L 40 40 L 0 40 Z\"/></symbol>" +
+            "</defs>" +
+            "<g style=\"fill:rgb(255,0,0);\"><use xlink:href=\"#square\" x=\"5\" y=\"5\"/></g>" +
+            "<g style=\"fill:rgb(0,0,255);\"><use xlink:href=\"#square\" x=\"55\" y=\"5\"/></g></svg>"
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+
+        let uses = svgDocument.children.flatMap() { ($0 as? SVGGroup)?.children.first as? SVGUse }
+        XCTAssert(uses.count == 2, "Both use elements should be instances")
+        XCTAssert(uses[0].referencedElement === uses[1].referencedElement, "Instances should share the referenced element")
+        XCTAssert(uses[0].referencedElement.parent == nil, "The referenced element should not be re-parented")
+        XCTAssert(uses[1].bounds == CGRect(x: 55, y: 5, width: 40, height: 40), "Use bounds should include the instance transform")
+
+        guard let optionalImage = try? SVGTiledRenderer.renderDocumentUntiled(svgDocument, size: CGSize(width: 100, height: 50)),
+            let image = optionalImage,
+            let data = CGDataProviderCopyData(CGImageGetDataProvider(image)) else {
+            XCTAssert(false, "Rendering should produce an image")
+            return
+        }
+        let bytes = UnsafePointer<UInt8>(CFDataGetBytePtr(data))
+        let bytesPerRow = CGImageGetBytesPerRow(image)
+        let left = 25 * bytesPerRow + 25 * 4
+        let right = 25 * bytesPerRow + 75 * 4
+        XCTAssert(bytes[left] == 255 && bytes[left + 2] == 0, "First instance should inherit red from its use element")
+        XCTAssert(bytes[right] == 0 && bytes[right + 2] == 255, "Second instance should inherit blue from its use element")
+    }
+
+    func testUseOfTopLevelElementInheritsFromUse() {
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" " +
+            "version=\"1.1\" viewBox=\"0 0 100 50\">" +
+            "<rect id=\"r\" x=\"5\" y=\"5\" width=\"40\" height=\"40\"/>" +
+            "<use xlink:href=\"#r\" x=\"50\" fill=\"rgb(255,0,0)\" stroke=\"blue\"/></svg>"
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument,
+            let use = svgDocument.children.last as? SVGUse else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        let rect = use.referencedElement
+        XCTAssert(rect.parent === svgDocument, "The referenced rect should keep its place in the document")
+        let context = SVGInstanceContext(use: use, outer: .None)
+        XCTAssert(rect.strokeColorInContext(.None) == nil, "The rect itself shouldn't be stroked")
+        XCTAssert(rect.strokeColorInContext(context) != nil, "The instance should inherit the use element's stroke")
+
+        guard let optionalImage = try? SVGTiledRenderer.renderDocumentUntiled(svgDocument, size: CGSize(width: 100, height: 50)),
+            let image = optionalImage,
+            let data = CGDataProviderCopyData(CGImageGetDataProvider(image)) else {
+            XCTAssert(false, "Rendering should produce an image")
+            return
+        }
+        let bytes = UnsafePointer<UInt8>(CFDataGetBytePtr(data))
+        let bytesPerRow = CGImageGetBytesPerRow(image)
+        let original = 25 * bytesPerRow + 25 * 4
+        let instance = 25 * bytesPerRow + 75 * 4
+        XCTAssert(bytes[original] == 0 && bytes[original + 3] == 255, "The rect itself should be filled black")
+        XCTAssert(bytes[instance] == 255 && bytes[instance + 2] == 0, "The instance should inherit red from its use element")
+    }
+
+    func testUseOfTopLevelElementInheritsGradientFromUse() {
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" " +
+            "version=\"1.1\" viewBox=\"0 0 100 50\">" +
+            "<defs><linearGradient id=\"red\"><stop offset=\"0\" stop-color=\"red\"/>" +
+            "<stop offset=\"1\" stop-color=\"red\"/></linearGradient></defs>" +
+            "<rect id=\"r\" x=\"5\" y=\"5\" width=\"40\" height=\"40\"/>" +
+            "<use xlink:href=\"#r\" x=\"50\" fill=\"url(#red)\"/></svg>"
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument,
+            let use = svgDocument.children.last as? SVGUse else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        let rect = use.referencedElement
+        let context = SVGInstanceContext(use: use, outer: .None)
+        XCTAssert(rect.gradientFillInContext(.None) == nil, "The rect itself shouldn't have a gradient")
+        XCTAssert(rect.linearGradientFillInContext(context) != nil, "The instance should inherit the use element's gradient")
+
+        guard let optionalImage = try? SVGTiledRenderer.renderDocumentUntiled(svgDocument, size: CGSize(width: 100, height: 50)),
+            let image = optionalImage,
+            let data = CGDataProviderCopyData(CGImageGetDataProvider(image)) else {
+            XCTAssert(false, "Rendering should produce an image")
+            return
+        }
+        let bytes = UnsafePointer<UInt8>(CFDataGetBytePtr(data))
+        let bytesPerRow = CGImageGetBytesPerRow(image)
+        let original = 25 * bytesPerRow + 25 * 4
+        let instance = 25 * bytesPerRow + 75 * 4
+        XCTAssert(bytes[original] == 0 && bytes[original + 3] == 255, "The rect itself should be filled black")
+        XCTAssert(bytes[instance] == 255 && bytes[instance + 2] == 0, "The instance should be filled with the gradient")
+    }
+
+    func testUseOfAncestorIsInvalidatedOnce() {
+        let group = SVGGroup()
+        let use = SVGUse(referencedElement: group)
+        group.children = [use]
+        use.parent = group
+        let generations = (group: group.generation, use: use.generation)
+
+        // The use instances the group containing it, so without stopping at
+        // elements already changed this would never return.
+        use.display = false
+        XCTAssert(use.generation == generations.use + 1, "The use element should change once")
+        XCTAssert(group.generation == generations.group + 1, "The group should change once")
+    }
+
+    func testDefinitionsAreMaterializedOnFirstUse() {
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" " +
+            "version=\"1.1\" viewBox=\"0 0 100 50\">" +
+            "<use xlink:href=\"#later\"/>" +
+            "<defs>" +
+            "<symbol id=\"used\"><path d=\"M 0 0 L 10 0 L 10 10 Z\"/></symbol>" +
+            "<symbol id=\"unused1\"><path d=\"M 0 0 L 10 0 L 10 10 Z\"/><path d=\"M 0 0 L 5 5\"/></symbol>" +
+            "<symbol id=\"unused2\"><path d=\"M 0 0 L 10 0 L 10 10 Z\"/></symbol>" +
+            "<linearGradient id=\"fade\"><stop offset=\"0\" stop-color=\"#000\"/></linearGradient>" +
+            "</defs>" +
+            "<symbol id=\"outside\"><path d=\"M 0 0 L 10 0 L 10 10 Z\"/></symbol>" +
+            "<use xlink:href=\"#used\"/>" +
+            "<path d=\"M 0 0 L 10 0 L 10 10 Z\" fill=\"url(#fade)\"/>" +
+            "<path id=\"later\" d=\"M 20 20 L 30 20 L 30 30 Z\"/></svg>"
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let rootElement = xmlDocument.rootElement() else {
+            XCTAssert(false, "Failed to parse the XML")
+            return
+        }
+        let state = SVGProcessor.State()
+        guard let optionalDocument = try? SVGProcessor().processSVGElement(rootElement, state: state),
+            let svgDocument = optionalDocument as? SVGDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+
+        XCTAssert(svgDocument.children.count == 4, "Symbols should not be rendered in place")
+        XCTAssert(state.elementsByID["unused1"] == nil && state.elementsByID["unused2"] == nil,
+                  "Unreferenced definitions should not be processed")
+        XCTAssert(state.elementsByID["outside"] == nil, "Unreferenced symbols should not be processed")
+        XCTAssert(state.deferredElementCount == 11, "Every element inside defs and symbols should be deferred")
+        XCTAssert(state.materializedElementCount == 4, "Only the referenced definitions should be materialized")
+        XCTAssert(svgDocument.children[2].gradientFill is SVGLinearGradient, "Gradients should be materialized by url references")
+
+        guard let forwardUse = svgDocument.children[0] as? SVGUse,
+            let laterPath = svgDocument.children[3] as? SVGPath else {
+            XCTAssert(false, "Forward references should resolve")
+            return
+        }
+        XCTAssert(forwardUse.referencedElement === laterPath, "A forward reference should share the element processed in place")
+    }
+
+    func testForwardReferencesKeepTheirAncestorsOpacity() {
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" " +
+            "version=\"1.1\" viewBox=\"0 0 100 50\">" +
+            "<g fill-opacity=\"0.25\"><use xlink:href=\"#later\"/></g>" +
+            "<g style=\"fill-opacity:0.5\"><g><rect id=\"later\" x=\"0\" y=\"0\" width=\"10\" height=\"10\" fill=\"red\"/></g>" +
+            "<rect x=\"20\" y=\"0\" width=\"10\" height=\"10\" fill=\"red\"/></g>" +
+            "<defs><rect id=\"defined\" x=\"0\" y=\"0\" width=\"10\" height=\"10\" fill=\"red\"/></defs>" +
+            "<g fill-opacity=\"0.25\"><use xlink:href=\"#defined\"/></g></svg>"
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument,
+            let laterGroup = svgDocument.children[1] as? SVGGroup,
+            let later = (laterGroup.children[0] as? SVGGroup)?.children.first,
+            let definedUse = (svgDocument.children[2] as? SVGGroup)?.children.first as? SVGUse else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        func alpha(element: SVGElement) -> CGFloat? {
+            return element.style?.fillColor.map() { CGColorGetAlpha($0) }
+        }
+        XCTAssert(alpha(later) == 0.5, "A forward reference should inherit its own ancestors' opacity")
+        XCTAssert(alpha(laterGroup.children[1]) == 0.5, "Elements processed in place should inherit opacity")
+        XCTAssert(alpha(definedUse.referencedElement) == 1.0, "Definitions shouldn't inherit the opacity where they are used")
+    }
+
+    func testTiledRenderingMatchesUntiled() {
+        let optionalSVGDocument: SVGDocument?
+        do {
+            let xmlDocument = try xmlDocumentFromNamedSVGFile("map")
+            let processor = SVGProcessor()
+            optionalSVGDocument = try processor.processXMLDocument(xmlDocument)
+        }
+        catch let error {
+            XCTAssert(false, "Failed to create SVGDocument: \(error)")
+            return
+        }
+
+        guard let svgDocument = optionalSVGDocument else {
+            XCTAssert(false, "optionalSVGDocument should not be .None")
+            return
+        }
+
+        let size = CGSize(width: 2130, height: 1256)
+        guard let untiled = try? SVGTiledRenderer.renderDocumentUntiled(svgDocument, size: size),
+            let untiledImage = untiled else {
+            XCTAssert(false, "Untiled rendering should produce an image")
+            return
+        }
+        guard let untiledData = CGDataProviderCopyData(CGImageGetDataProvider(untiledImage)) else {
+            XCTAssert(false, "Untiled image should have pixel data")
+            return
+        }
+
+        for threadCount in [1, 4] {
+            let tiledRenderer = SVGTiledRenderer()
+            tiledRenderer.threadCount = threadCount
+            tiledRenderer.tileSize = 200
+            guard let tiled = try? tiledRenderer.renderDocument(svgDocument, size: size),
+                let tiledImage = tiled else {
+                XCTAssert(false, "Tiled rendering should produce an image")
+                return
+            }
+            guard let tiledData = CGDataProviderCopyData(CGImageGetDataProvider(tiledImage)) else {
+                XCTAssert(false, "Tiled image should have pixel data")
+                return
+            }
+            XCTAssert((untiledData as NSData).isEqualToData(tiledData as NSData), "Tiled rendering with \(threadCount) threads should be pixel identical")
+        }
+    }
+
+    func testFrozenDocumentRendersConcurrently() {
+        guard let xmlDocument = try? xmlDocumentFromNamedSVGFile("paperplane"),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument,
+            let frozenDocument = try? svgDocument.freeze() else {
+            XCTAssert(false, "Failed to create and freeze SVGDocument")
+            return
+        }
+        XCTAssert(!frozenDocument.elementBounds.isEmpty, "Every rendered element should have bounds")
+
+        // Several sizes at once from the one snapshot.
+        let sizes = [CGSize(width: 500, height: 260), CGSize(width: 250, height: 130), CGSize(width: 1000, height: 520)]
+        var images = [CGImage?](count: sizes.count, repeatedValue: .None)
+        images.withUnsafeMutableBufferPointer() {
+            (inout buffer: UnsafeMutableBufferPointer<CGImage?>) -> Void in
+            let imagesPointer = buffer.baseAddress
+            dispatch_apply(sizes.count, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0)) { index in
+                let tiledRenderer = SVGTiledRenderer()
+                tiledRenderer.tileSize = 64
+                imagesPointer[index] = (try? tiledRenderer.renderDocument(frozenDocument, size: sizes[index])) ?? .None
+            }
+        }
+
+        for (size, image) in zip(sizes, images) {
+            guard let tiledImage = image,
+                let untiled = try? SVGTiledRenderer.renderDocumentUntiled(svgDocument, size: size),
+                let untiledImage = untiled,
+                let tiledData = CGDataProviderCopyData(CGImageGetDataProvider(tiledImage)),
+                let untiledData = CGDataProviderCopyData(CGImageGetDataProvider(untiledImage)) else {
+                XCTAssert(false, "Rendering at \(size) should produce an image")
+                continue
+            }
+            XCTAssert((untiledData as NSData).isEqualToData(tiledData as NSData),
+                      "The frozen document rendered at \(size) should match the document")
+        }
+    }
+
+    func testTileExporter() {
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" viewBox=\"0 0 512 256\">" +
+            "<rect x=\"0\" y=\"0\" width=\"100\" height=\"100\" fill=\"red\"/></svg>"
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument,
+            let exporter = try? SVGTileExporter(svgDocument: svgDocument) else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        XCTAssert(exporter.tileCount(zoom: 2).columns == 4 && exporter.tileCount(zoom: 2).rows == 2,
+                  "Tiles should only cover the viewBox")
+
+        let directory = NSURL(fileURLWithPath: NSTemporaryDirectory()).URLByAppendingPathComponent(
+            "SVGTileExporter-\(NSUUID().UUIDString)", isDirectory: true)
+        defer {
+            let _ = try? NSFileManager.defaultManager().removeItemAtURL(directory)
+        }
+        guard let report = try? exporter.exportTiles(0...2, directory: directory) else {
+            XCTAssert(false, "Exporting the tiles should succeed")
+            return
+        }
+        XCTAssert(report.tileCount == 11 && report.writtenTileCount == 3 && report.emptyTileCount == 8,
+                  "Only the tiles the rectangle is in should be written")
+        XCTAssert(report.writtenTileCount + report.emptyTileCount == report.tileCount,
+                  "Every tile should be either written or skipped")
+        XCTAssert(report.seconds > 0.0 && report.tilesPerSecond > 0.0, "The export should be timed")
+        XCTAssert(report.description.hasPrefix("11 tiles, 3 written, 8 empty, "), "The report should describe the export")
+        let fileManager = NSFileManager.defaultManager()
+        for path in ["0/0/0.png", "1/0/0.png", "2/0/0.png"] {
+            XCTAssert(fileManager.fileExistsAtPath(directory.URLByAppendingPathComponent(path).path!),
+                      "\(path) should be written")
+        }
+        XCTAssert(!fileManager.fileExistsAtPath(directory.URLByAppendingPathComponent("2/1/0.png").path!),
+                  "Empty tiles should be skipped")
+
+        if let data = NSData(contentsOfURL: directory.URLByAppendingPathComponent("2/0/0.png")) where data.length > 8 {
+            let signature = UnsafePointer<UInt8>(data.bytes)
+            XCTAssert(signature[1] == 0x50 && signature[2] == 0x4E && signature[3] == 0x47, "Tiles should be PNGs")
+        }
+        else {
+            XCTAssert(false, "The tile should have been written")
+        }
+    }
+
+    func testLayerCache() {
+        guard let xmlDocument = try? xmlDocumentFromNamedSVGFile("map"),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument,
+            let frozenDocument = try? svgDocument.freeze() else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        let size = CGSize(width: 1065, height: 628)
+        func draw(layerCache: SVGLayerCache, scale: CGFloat) -> CGContext {
+            let context = SVGTiledRenderer.makeBitmapContext(Int(size.width * scale), height: Int(size.height * scale))!
+            CGContextConcatCTM(context, SVGTiledRenderer.documentTransform(svgDocument,
+                size: CGSize(width: size.width * scale, height: size.height * scale)))
+            try! layerCache.draw(frozenDocument, context: context)
+            return context
+        }
+
+        let layerCache = SVGLayerCache()
+        let context = draw(layerCache, scale: 1.0)
+        let misses = layerCache.missCount
+        XCTAssert(misses > 0 && layerCache.hitCount == 0, "The first draw should rasterize the groups")
+        XCTAssert(layerCache.byteCount > 0, "The layers' memory should be counted")
+        draw(layerCache, scale: 1.2)
+        XCTAssert(layerCache.missCount == misses && layerCache.hitCount == misses,
+                  "A small change of scale should reuse the layers")
+        // Changing the document doesn't change the snapshot being drawn.
+        svgDocument.children[0].display = true
+        draw(layerCache, scale: 1.2)
+        XCTAssert(layerCache.missCount == misses && layerCache.hitCount == 2 * misses,
+                  "Layers should be kept while the snapshot they were drawn from is unchanged")
+        draw(layerCache, scale: 2.0)
+        XCTAssert(layerCache.missCount == 2 * misses, "Zooming past the threshold should rasterize the groups again")
+
+        // The layers should look like the document drawn directly.
+        let direct = SVGTiledRenderer.makeBitmapContext(Int(size.width), height: Int(size.height))!
+        CGContextConcatCTM(direct, SVGTiledRenderer.documentTransform(svgDocument, size: size))
+        try! frozenDocument.render(direct)
+        let layerBytes = UnsafePointer<UInt8>(CGBitmapContextGetData(context))
+        let directBytes = UnsafePointer<UInt8>(CGBitmapContextGetData(direct))
+        var differingBytes = 0
+        for index in 0..<CGBitmapContextGetBytesPerRow(direct) * CGBitmapContextGetHeight(direct)
+            where abs(Int(layerBytes[index]) - Int(directBytes[index])) > 8 {
+            differingBytes += 1
+        }
+        XCTAssert(differingBytes < 1000, "Drawing from layers should match drawing the document")
+
+        let boundedCache = SVGLayerCache()
+        boundedCache.minimumElementCount = 2
+        boundedCache.maximumByteCount = 1024 * 1024
+        draw(boundedCache, scale: 1.0)
+        XCTAssert(boundedCache.byteCount <= boundedCache.maximumByteCount || boundedCache.count == 1,
+                  "Layers should be evicted to keep within the memory limit")
+    }
+
+    func testTiledRenderingScaling() {
+        guard let xmlDocument = try? xmlDocumentFromNamedSVGFile("map"),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+
+        // A fractional size checks both round it up the same way.
+        let size = CGSize(width: 532.5, height: 314.25)
+        guard let untiled = try? SVGTiledRenderer.renderDocumentUntiled(svgDocument, size: size),
+            let untiledImage = untiled,
+            let untiledData = CGDataProviderCopyData(CGImageGetDataProvider(untiledImage)) else {
+            XCTAssert(false, "Untiled rendering should produce an image")
+            return
+        }
+        XCTAssert(CGImageGetWidth(untiledImage) == 533 && CGImageGetHeight(untiledImage) == 315,
+                  "A fractional size should be rounded up")
+        for threadCount in [1, 2, 4, 8, 16, 32] {
+            let tiledRenderer = SVGTiledRenderer()
+            tiledRenderer.threadCount = threadCount
+            tiledRenderer.tileSize = 64
+            guard let tiled = try? tiledRenderer.renderDocument(svgDocument, size: size),
+                let tiledImage = tiled,
+                let tiledData = CGDataProviderCopyData(CGImageGetDataProvider(tiledImage)) else {
+                XCTAssert(false, "Tiled rendering with \(threadCount) threads should produce an image")
+                return
+            }
+            XCTAssert((untiledData as NSData).isEqualToData(tiledData as NSData),
+                      "Tiled rendering with \(threadCount) threads should be pixel identical")
+        }
+
+        // Poster resolution, 4x the map's viewBox, on every core.
+        let tiledRenderer = SVGTiledRenderer()
+        measureBlock() {
+            let _ = try? tiledRenderer.renderDocument(svgDocument, size: CGSize(width: 4260, height: 2512))
+        }
+    }
+
+    func testSyntheticDocumentIsDeterministic() {
+        var parameters = SVGSyntheticDocument()
+        parameters.nestingDepth = 3
+        parameters.transformDensity = 0.5
+        parameters.useFanOut = 10
+        XCTAssert(parameters.source == parameters.source, "The same seed should generate the same document")
+        var reseeded = parameters
+        reseeded.seed = 2
+        XCTAssert(parameters.source != reseeded.source, "A different seed should generate a different document")
+
+        guard let optionalDocument = try? SVGProcessor().processData(parameters.data),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "The generated document should process")
+            return
+        }
+        var pathCount = 0
+        var useCount = 0
+        SVGElement.walker.walk(svgDocument) {
+            (element: SVGElement, depth: Int) -> Void in
+            pathCount += element is SVGPath ? 1 : 0
+            useCount += element is SVGUse ? 1 : 0
+        }
+        XCTAssert(pathCount == parameters.elementCount, "Every generated path should be in the document")
+        XCTAssert(useCount == parameters.useFanOut, "Every generated use element should be in the document")
+    }
+
+    /// Measures how the cost of each stage grows along each dimension.
+    func testScalingBenchmark() {
+        let benchmark = SVGScalingBenchmark()
+        let curves = [
+            benchmark.measure("elements", values: [100, 200, 400, 800, 1600]) {
+                var document = SVGSyntheticDocument()
+                document.elementCount = Int($0)
+                return document
+            },
+            benchmark.measure("depth", values: [1, 4, 16, 64]) {
+                var document = SVGSyntheticDocument()
+                document.nestingDepth = Int($0)
+                return document
+            },
+            benchmark.measure("pathLength", values: [4, 16, 64, 256]) {
+                var document = SVGSyntheticDocument()
+                document.pathLength = Int($0)
+                return document
+            },
+            benchmark.measure("transforms", values: [0.0, 0.25, 0.5, 1.0]) {
+                var document = SVGSyntheticDocument()
+                document.transformDensity = $0
+                return document
+            },
+            benchmark.measure("useFanOut", values: [25, 100, 400, 1600]) {
+                var document = SVGSyntheticDocument()
+                document.useFanOut = Int($0)
+                return document
+            }
+        ]
+        for curve in curves {
+            for stage in SVGScalingBenchmark.Stage.allStages {
+                XCTAssert(curve.times[stage]?.count == curve.values.count,
+                          "\(stage.rawValue) should be measured at every \(curve.dimension)")
+                XCTAssert(!(curve.times[stage] ?? []).contains({ $0 <= 0.0 }),
+                          "Every \(stage.rawValue) time along \(curve.dimension) should be positive")
+                XCTAssert(curve.exponent(stage) != nil || curve.values.first == 0.0,
+                          "\(stage.rawValue) should have a growth exponent along \(curve.dimension)")
+            }
+            let lines = curve.report.componentsSeparatedByString("\n")
+            XCTAssert(lines.count == curve.values.count + 2 && lines.first!.hasPrefix(curve.dimension + "\t") &&
+                      lines.last!.hasPrefix("exponent\t"),
+                      "The \(curve.dimension) report should have a header, a row for each value and the exponents")
+        }
+    }
+
+    func testPathGeometryBounds() {
+        // The control points pull the curve up to y = 75 at t = 0.5, well short of 100.
+        let path = CGPathCreateMutable()
+        CGPathMoveToPoint(path, nil, 0.0, 0.0)
+        CGPathAddCurveToPoint(path, nil, 0.0, 100.0, 100.0, 100.0, 100.0, 0.0)
+        CGPathAddQuadCurveToPoint(path, nil, 150.0, -100.0, 200.0, 0.0)
+        let geometry = SVGPathGeometry(path: path)
+        XCTAssert(geometry.verbs == [.moveTo, .curveTo, .quadCurveTo], "Geometry should have a move, a cubic and a quad")
+        XCTAssert(geometry.points.count == 6, "Geometry should hold 6 points")
+        XCTAssert(geometry.bounds == CGRect(x: 0.0, y: -50.0, width: 200.0, height: 125.0), "Bounds should be exact: \(geometry.bounds)")
+        XCTAssert(CGPathEqualToPath(geometry.makeCGPath(), path), "Geometry should convert back to the same path")
+
+        guard let xmlDocument = try? xmlDocumentFromNamedSVGFile("map"),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+
+        var pathCount = 0
+        SVGElement.walker.walk(svgDocument) {
+            (element: SVGElement, depth: Int) -> Void in
+            guard let pathGenerator = element as? PathGenerator else {
+                return
+            }
+            let expected = CGPathGetPathBoundingBox(pathGenerator.cgpath)
+            let bounds = element.localBounds
+            let tolerance: CGFloat = 1.0e-3
+            XCTAssert(abs(bounds.minX - expected.minX) < tolerance && abs(bounds.minY - expected.minY) < tolerance
+                && abs(bounds.maxX - expected.maxX) < tolerance && abs(bounds.maxY - expected.maxY) < tolerance,
+                "Bounds \(bounds) should match \(expected)")
+            pathCount += 1
+        }
+        XCTAssert(pathCount > 0, "The map should contain paths")
+
+        XCTAssert(!svgDocument.bounds.isNull, "Document bounds should not be null")
+
+        let svgPath = SVGPath(path: path, svgPath: "")
+        let group = SVGGroup(children: [svgPath])
+        XCTAssert(group.localBounds == geometry.bounds, "Group bounds should be the bounds of its only child")
+        svgPath.transform = Translate(tx: 10.0, ty: 0.0)
+        XCTAssert(group.localBounds == geometry.bounds.offsetBy(dx: 10.0, dy: 0.0),
+            "Changing a child's transform should invalidate the cached group bounds")
+    }
+
+    func testSimplification() {
+        let source = "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" viewBox=\"0 0 100 100\">" +
+            "<polyline points=\"0,0 10,0.01 20,0 30,0 30,10\"/>" +
+            "<polygon points=\"0,0 5,0 10,0 10,5 10,10 5,10 0,10 0,5\"/>" +
+            "<polygon points=\"0,0 0.01,0 0.01,0.01\"/>" +
+            "<path d=\"M 0 0 L 10 0.01 L 20 0 C 25 5 30 5 35 0 L 40 0 L 40 10 L 20 10 L 0 10 Z\"/>" +
+            "<g transform=\"scale(100)\"><polyline points=\"0,0 0.5,0.01 1,0\"/></g></svg>"
+        guard let xmlDocument = try? NSXMLDocument(XMLString: source, options: 0),
+            let optionalDocument = try? SVGProcessor().processXMLDocument(xmlDocument),
+            let svgDocument = optionalDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+
+        let report = svgDocument.simplify(0.1)
+        XCTAssert(report.elementCount == 5, "Every polyline, polygon and path should be considered")
+        XCTAssert(report.vertexCount == 29 && report.simplifiedVertexCount == 21,
+                  "Vertices should go from 29 to 21, not \(report.vertexCount) to \(report.simplifiedVertexCount)")
+        XCTAssert(report.simplifiedPathDataLength < report.pathDataLength, "The path data should be shorter")
+
+        let polyline = svgDocument.children[0] as! SVGPolyline
+        XCTAssert(polyline.points == [CGPoint(x: 0, y: 0), CGPoint(x: 30, y: 0), CGPoint(x: 30, y: 10)],
+                  "Collinear polyline vertices should be removed")
+        let square = svgDocument.children[1] as! SVGPolygon
+        XCTAssert(square.polygon.points.count == 4, "The square's edge midpoints should be removed")
+        let triangle = svgDocument.children[2] as! SVGPolygon
+        XCTAssert(triangle.polygon.points.count == 3, "A ring smaller than the tolerance should not collapse")
+        let path = svgDocument.children[3] as! SVGPath
+        XCTAssert(path.svgpath == "M0 0L20 0C25 5 30 5 35 0L40 0L40 10L0 10Z",
+                  "Only the line runs of the path should be simplified, not \(path.svgpath)")
+        let scaled = (svgDocument.children[4] as! SVGGroup).children[0] as! SVGPolyline
+        XCTAssert(scaled.points.count == 3, "The tolerance should be scaled by the element's transform")
+
+        let curveSource = "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" viewBox=\"0 0 100 100\">" +
+            "<path d=\"M 0 0 C 10 1 20 1 30 0\"/></svg>"
+        guard let curveXMLDocument = try? NSXMLDocument(XMLString: curveSource, options: 0),
+            let optionalCurveDocument = try? SVGProcessor().processXMLDocument(curveXMLDocument),
+            let curveDocument = optionalCurveDocument else {
+            XCTAssert(false, "Failed to create SVGDocument")
+            return
+        }
+        XCTAssert(curveDocument.simplify(1.0).simplifiedElementCount == 0, "Curves should be kept by default")
+        XCTAssert(curveDocument.simplify(1.0, flattensCurves: true).simplifiedElementCount == 1,
+                  "A flattened curve should be simplified")
+        let curve = curveDocument.children[0] as! SVGPath
+        XCTAssert(curve.svgpath == "M0 0L30 0", "A shallow curve should become one line, not \(curve.svgpath)")
     }
 
     func testRPM_NavBall_Overlay() {